@@ -146,11 +146,19 @@ AAC_DEF void *arena_alloc(Arena *t_arena, size_t t_size_in_bytes) {
 
   if (arena->m_active->m_chunk_current_count + chunk_count >
       arena->m_active->m_chunk_max_count) {
-    size_t chunk_max_count = DEFAULT_CHUNK_MAX_COUNT;
-    if (chunk_max_count < chunk_count)
-      chunk_max_count = chunk_count;
-    arena->m_active->m_next = buffer_new(chunk_max_count);
-    arena->m_active = arena->m_active->m_next;
+    // The buffers after the active one were emptied by arena_reset(), reuse
+    // the next one if the data fits, else put a new one in front of it
+    Buffer *next_buffer = arena->m_active->m_next;
+    if (next_buffer == NULL || next_buffer->m_chunk_max_count < chunk_count) {
+      size_t chunk_max_count = DEFAULT_CHUNK_MAX_COUNT;
+      if (chunk_max_count < chunk_count)
+        chunk_max_count = chunk_count;
+      Buffer *new_buffer = buffer_new(chunk_max_count);
+      new_buffer->m_next = next_buffer;
+      next_buffer = new_buffer;
+      arena->m_active->m_next = next_buffer;
+    }
+    arena->m_active = next_buffer;
   }
 
   void *result =
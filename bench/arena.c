@@ -0,0 +1,75 @@
+// Many small allocations, given back all at once: malloc/free next to
+// arena_alloc/arena_reset, directly and through rda_allocator, which adds an
+// indirect call. std.cpp has the same case with new/delete and
+// std::pmr::monotonic_buffer_resource.
+
+#include "bench.h"
+
+#include "bench_alloc.h"
+
+#define OBJECT_COUNT (1 << 20)
+
+struct small_objects {
+  void **m_ptrs;
+  rda_allocator *m_allocator;
+};
+
+// 16 to 72 bytes, the sizes of small structs and short strings
+static inline size_t object_size(size_t t_index) {
+  return 16 + (t_index * 7 % 8) * 8;
+}
+
+static void run_malloc(void *t_ctx) {
+  struct small_objects *objects = t_ctx;
+  for (size_t i = 0; i < OBJECT_COUNT; i++) {
+    objects->m_ptrs[i] = malloc(object_size(i));
+    *(size_t *)objects->m_ptrs[i] = i;
+  }
+  bench_clobber();
+  for (size_t i = 0; i < OBJECT_COUNT; i++) {
+    free(objects->m_ptrs[i]);
+  }
+}
+
+static void run_arena(void *t_ctx) {
+  struct small_objects *objects = t_ctx;
+  for (size_t i = 0; i < OBJECT_COUNT; i++) {
+    objects->m_ptrs[i] = arena_alloc(&bench_arena, object_size(i));
+    *(size_t *)objects->m_ptrs[i] = i;
+  }
+  bench_clobber();
+  arena_reset(&bench_arena);
+}
+
+static void run_allocator(void *t_ctx) {
+  struct small_objects *objects = t_ctx;
+  rda_allocator *allocator = objects->m_allocator;
+  for (size_t i = 0; i < OBJECT_COUNT; i++) {
+    objects->m_ptrs[i] = allocator->alloc(allocator->m_ctx, object_size(i));
+    *(size_t *)objects->m_ptrs[i] = i;
+  }
+  bench_clobber();
+  for (size_t i = 0; i < OBJECT_COUNT; i++) {
+    allocator->free(allocator->m_ctx, objects->m_ptrs[i]);
+  }
+  if (allocator == &arena_allocator) {
+    arena_reset(&bench_arena);
+  }
+}
+
+int main() {
+  struct small_objects objects = {malloc(OBJECT_COUNT * sizeof(void *)),
+                                  NULL};
+  bench_run("alloc", "small_objects", "malloc", OBJECT_COUNT, NULL,
+            run_malloc, &objects);
+  bench_run("alloc", "small_objects", "arena", OBJECT_COUNT, NULL, run_arena,
+            &objects);
+  objects.m_allocator = &libc_allocator;
+  bench_run("alloc", "small_objects", "rda_allocator/libc", OBJECT_COUNT,
+            NULL, run_allocator, &objects);
+  objects.m_allocator = &arena_allocator;
+  bench_run("alloc", "small_objects", "rda_allocator/arena", OBJECT_COUNT,
+            NULL, run_allocator, &objects);
+  arena_free(&bench_arena);
+  free(objects.m_ptrs);
+}
@@ -0,0 +1,260 @@
+// Shared harness of the benchmarks, usable from C and C++.
+//
+// Every case is run once to warm up, then BENCH_RUNS times (15 by default).
+// The fastest and the median run are reported as one JSON object per line on
+// stdout, and as a table on stderr. On Linux the fastest run also reports
+// cycles, instructions and cache misses, when perf_event_open() is allowed,
+// else they are null. Define BENCH_NO_PERF to leave the counters out.
+//
+// Environment:
+//   BENCH_RUNS    number of timed runs per case
+//   BENCH_FILTER  only run cases whose "group/name" contains this string
+
+#ifndef BENCH_H_INCLUDED
+#define BENCH_H_INCLUDED
+
+// clock_gettime() and syscall(), this header has to come first
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__) && !defined(BENCH_NO_PERF)
+#define _BENCH_PERF
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define BENCH_MAX_RUNS 101
+
+/// @brief Keep a value alive, so the compiler can't drop the work behind it.
+static inline void bench_sink(uint64_t t_val) {
+  static volatile uint64_t sink;
+  sink = sink ^ t_val;
+}
+
+/// @brief Make the compiler assume memory was read and written, so stores
+/// into buffers that are never read again are kept.
+static inline void bench_clobber(void) {
+#if defined(__GNUC__)
+  __asm__ __volatile__("" : : : "memory");
+#endif
+}
+
+/// @brief Fill t_letters with t_count random words of 3 to 24 letters, one
+/// after the other, and t_sizes with their sizes.
+///
+/// t_letters needs room for 24 letters per word. The words are the same in
+/// every benchmark, C or C++.
+static inline void bench_words(char *t_letters, size_t *t_sizes,
+                               size_t t_count) {
+  srand(1);
+  for (size_t i = 0; i < t_count; i++) {
+    t_sizes[i] = 3 + (size_t)rand() % 22;
+    for (size_t j = 0; j < t_sizes[i]; j++) {
+      *t_letters++ = (char)('a' + rand() % 26);
+    }
+  }
+}
+
+/// @brief Write lines of 7 words from `bench_words()` to t_file, until it
+/// holds at least t_size bytes.
+static inline void bench_write_text(FILE *t_file, const char *t_letters,
+                                    const size_t *t_sizes, size_t t_count,
+                                    size_t t_size) {
+  const char *word = t_letters;
+  for (size_t size = 0, i = 0; size < t_size; i++) {
+    if (i % t_count == 0) {
+      word = t_letters;
+    }
+    size += fwrite(word, 1, t_sizes[i % t_count], t_file);
+    size += fwrite(i % 7 == 6 ? "\n" : " ", 1, 1, t_file);
+    word += t_sizes[i % t_count];
+  }
+  fflush(t_file);
+}
+
+/// @internal
+static inline uint64_t _bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/// @internal
+/// @brief The counters of a run, UINT64_MAX if they could not be read.
+struct _bench_counters {
+  uint64_t m_cycles;
+  uint64_t m_instructions;
+  uint64_t m_cache_misses;
+};
+
+#ifdef _BENCH_PERF
+/// @internal
+/// @brief The perf event group, -1 once it failed to open.
+static int _bench_perf_fd = -2;
+
+/// @internal
+static inline int _bench_perf_open(uint64_t t_config, int t_group) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = t_config;
+  attr.disabled = t_group == -1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, t_group, 0);
+}
+
+/// @internal
+/// @brief Open the three counters as one group, so they count the same code.
+static inline int _bench_perf_group(void) {
+  if (_bench_perf_fd != -2) {
+    return _bench_perf_fd;
+  }
+  int group = _bench_perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+  if (group >= 0 &&
+      (_bench_perf_open(PERF_COUNT_HW_INSTRUCTIONS, group) < 0 ||
+       _bench_perf_open(PERF_COUNT_HW_CACHE_MISSES, group) < 0)) {
+    // A partial group is closed with the leader, the members are left to the
+    // end of the process
+    close(group);
+    group = -1;
+  }
+  _bench_perf_fd = group < 0 ? -1 : group;
+  return _bench_perf_fd;
+}
+#endif // _BENCH_PERF
+
+/// @internal
+static inline void _bench_counters_start(void) {
+#ifdef _BENCH_PERF
+  int group = _bench_perf_group();
+  if (group >= 0) {
+    ioctl(group, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif // _BENCH_PERF
+}
+
+/// @internal
+static inline struct _bench_counters _bench_counters_stop(void) {
+  struct _bench_counters counters = {UINT64_MAX, UINT64_MAX, UINT64_MAX};
+#ifdef _BENCH_PERF
+  int group = _bench_perf_group();
+  if (group >= 0) {
+    ioctl(group, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    // The number of counters, then their values in the order they were opened
+    uint64_t values[4];
+    if (read(group, values, sizeof(values)) == (ssize_t)sizeof(values) &&
+        values[0] == 3) {
+      counters.m_cycles = values[1];
+      counters.m_instructions = values[2];
+      counters.m_cache_misses = values[3];
+    }
+  }
+#endif // _BENCH_PERF
+  return counters;
+}
+
+/// @internal
+static inline int _bench_cmp_u64(const void *t_lhs, const void *t_rhs) {
+  uint64_t lhs = *(const uint64_t *)t_lhs;
+  uint64_t rhs = *(const uint64_t *)t_rhs;
+  return lhs < rhs ? -1 : lhs > rhs;
+}
+
+/// @internal
+static inline void _bench_print_counter(const char *t_name, uint64_t t_val) {
+  if (t_val == UINT64_MAX) {
+    printf(",\"%s\":null", t_name);
+  } else {
+    printf(",\"%s\":%llu", t_name, (unsigned long long)t_val);
+  }
+}
+
+/// @brief Time a case and print its results.
+///
+/// Cases that compare implementations of the same thing share t_group and
+/// t_name and differ in t_impl.
+/// @param t_ops The number of operations one call of t_run does, the results
+/// are also given per operation
+/// @param t_setup Called before every run without being timed, may be NULL
+/// @param t_run The timed work
+static inline void bench_run(const char *t_group, const char *t_name,
+                             const char *t_impl, size_t t_ops,
+                             void (*t_setup)(void *), void (*t_run)(void *),
+                             void *t_ctx) {
+  const char *filter = getenv("BENCH_FILTER");
+  if (filter && *filter) {
+    char full_name[256];
+    snprintf(full_name, sizeof(full_name), "%s/%s", t_group, t_name);
+    if (!strstr(full_name, filter)) {
+      return;
+    }
+  }
+  int runs = 15;
+  const char *runs_env = getenv("BENCH_RUNS");
+  if (runs_env && atoi(runs_env) > 0) {
+    runs = atoi(runs_env);
+  }
+  runs = runs < BENCH_MAX_RUNS ? runs : BENCH_MAX_RUNS;
+
+  uint64_t times[BENCH_MAX_RUNS];
+  uint64_t min = UINT64_MAX;
+  struct _bench_counters best = {UINT64_MAX, UINT64_MAX, UINT64_MAX};
+  // The first run only warms up the caches and the allocator
+  for (int i = -1; i < runs; i++) {
+    if (t_setup) {
+      t_setup(t_ctx);
+    }
+    _bench_counters_start();
+    uint64_t start = _bench_now_ns();
+    t_run(t_ctx);
+    uint64_t time = _bench_now_ns() - start;
+    struct _bench_counters counters = _bench_counters_stop();
+    if (i < 0) {
+      continue;
+    }
+    times[i] = time;
+    if (time < min) {
+      min = time;
+      best = counters;
+    }
+  }
+  qsort(times, (size_t)runs, sizeof(uint64_t), _bench_cmp_u64);
+  uint64_t median = times[runs / 2];
+  double ops = t_ops ? (double)t_ops : 1.0;
+
+  printf("{\"group\":\"%s\",\"name\":\"%s\",\"impl\":\"%s\",\"ops\":%zu,"
+         "\"runs\":%d,\"min_ns\":%llu,\"median_ns\":%llu,\"ns_per_op\":%.3f",
+         t_group, t_name, t_impl, t_ops, runs, (unsigned long long)min,
+         (unsigned long long)median, (double)min / ops);
+  _bench_print_counter("cycles", best.m_cycles);
+  _bench_print_counter("instructions", best.m_instructions);
+  _bench_print_counter("cache_misses", best.m_cache_misses);
+  printf("}\n");
+  fflush(stdout);
+
+  char full_name[256];
+  snprintf(full_name, sizeof(full_name), "%s/%s", t_group, t_name);
+  fprintf(stderr, "%-28s %-20s %12.3f ns/op %12.3f ms", full_name, t_impl,
+          (double)min / ops, (double)min * 1e-6);
+  if (best.m_cycles != UINT64_MAX) {
+    fprintf(stderr, " %8.2f IPC %10.3f misses/op",
+            best.m_cycles ? (double)best.m_instructions / best.m_cycles : 0.0,
+            (double)best.m_cache_misses / ops);
+  }
+  fprintf(stderr, "\n");
+}
+
+#endif // BENCH_H_INCLUDED
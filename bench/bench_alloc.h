@@ -0,0 +1,56 @@
+// The allocators the C benchmarks run the containers with: libc, and an arena
+// behind the same rda_allocator interface, where free does nothing and the
+// memory is given back all at once with arena_reset().
+
+#ifndef BENCH_ALLOC_H_INCLUDED
+#define BENCH_ALLOC_H_INCLUDED
+
+#include <stdlib.h>
+
+// Every benchmark is a single translation unit
+#define ARENA_ALLOCATOR_IMPLEMENTATION
+#include "../arena_allocator.h"
+#include "../rit_dyn_arr.h"
+
+static void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+static void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+static void *libc_realloc(void *t_ctx, void *t_old_ptr,
+                          size_t t_old_size_in_bytes,
+                          size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+static void *bench_arena_alloc(void *t_ctx, size_t t_size_in_bytes) {
+  return arena_alloc((Arena *)t_ctx, t_size_in_bytes);
+}
+
+static void bench_arena_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  (void)t_ptr;
+}
+
+static void *bench_arena_realloc(void *t_ctx, void *t_old_ptr,
+                                 size_t t_old_size_in_bytes,
+                                 size_t t_new_size_in_bytes) {
+  return arena_realloc((Arena *)t_ctx, t_old_ptr, t_old_size_in_bytes,
+                       t_new_size_in_bytes);
+}
+
+static Arena bench_arena = {NULL, NULL};
+
+static rda_allocator libc_allocator = {libc_malloc, libc_free, libc_realloc,
+                                       NULL};
+static rda_allocator arena_allocator = {bench_arena_alloc, bench_arena_free,
+                                        bench_arena_realloc, &bench_arena};
+
+#endif // BENCH_ALLOC_H_INCLUDED
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""Compare two result files of `make run`, case by case.
+
+usage: compare.py OLD NEW [THRESHOLD]
+
+Prints the change of ns_per_op of every case in both files. Exits with 1
+if a case got slower by more than THRESHOLD percent, 5 by default.
+"""
+
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path) as file:
+        for line in file:
+            if line.strip():
+                result = json.loads(line)
+                key = (result["group"], result["name"], result["impl"])
+                results[key] = result
+    return results
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        sys.exit(__doc__.strip())
+    old = load(sys.argv[1])
+    new = load(sys.argv[2])
+    threshold = float(sys.argv[3]) if len(sys.argv) == 4 else 5.0
+
+    slower = 0
+    print(f"{'case':<48} {'old ns/op':>12} {'new ns/op':>12} {'change':>8}")
+    for key, result in new.items():
+        if key not in old:
+            continue
+        before = old[key]["ns_per_op"]
+        after = result["ns_per_op"]
+        change = (after - before) / before * 100 if before else 0.0
+        mark = ""
+        if change > threshold:
+            mark = "  slower"
+            slower += 1
+        elif change < -threshold:
+            mark = "  faster"
+        name = f"{key[0]}/{key[1]} {key[2]}"
+        print(f"{name:<48} {before:12.3f} {after:12.3f} "
+              f"{change:+7.1f}%{mark}")
+    sys.exit(1 if slower else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,81 @@
+// rda_push_back, rda_insert and rda_erase on arrays of int, with libc and
+// with an arena behind the allocator. std.cpp does the same with
+// std::vector.
+
+#include "bench.h"
+
+#include "bench_alloc.h"
+
+#define PUSH_COUNT (1 << 20)
+// Inserting and erasing in the middle moves half the array every time
+#define SHIFT_COUNT (1 << 14)
+
+struct ints {
+  rda_struct(int) m_arr;
+  rda_allocator *m_allocator;
+};
+
+static void run_push_back(void *t_ctx) {
+  struct ints *ints = t_ctx;
+  rda_init(ints->m_arr, 0, sizeof(int), ints->m_allocator);
+  for (int k = 0; k < PUSH_COUNT; k++) {
+    rda_push_back(ints->m_arr, k, ints->m_allocator);
+  }
+  bench_sink((uint64_t)rda_back(ints->m_arr));
+  rda_free(ints->m_arr, ints->m_allocator);
+  if (ints->m_allocator == &arena_allocator) {
+    arena_reset(&bench_arena);
+  }
+}
+
+static void run_insert_middle(void *t_ctx) {
+  struct ints *ints = t_ctx;
+  rda_init(ints->m_arr, 0, sizeof(int), ints->m_allocator);
+  for (int k = 0; k < SHIFT_COUNT; k++) {
+    rda_insert(ints->m_arr, rda_size(ints->m_arr) / 2, 1, k,
+               ints->m_allocator);
+  }
+  bench_sink((uint64_t)rda_front(ints->m_arr));
+  rda_free(ints->m_arr, ints->m_allocator);
+  if (ints->m_allocator == &arena_allocator) {
+    arena_reset(&bench_arena);
+  }
+}
+
+static void setup_erase(void *t_ctx) {
+  struct ints *ints = t_ctx;
+  rda_init(ints->m_arr, 0, sizeof(int), ints->m_allocator);
+  for (int k = 0; k < SHIFT_COUNT; k++) {
+    rda_push_back(ints->m_arr, k, ints->m_allocator);
+  }
+}
+
+static void run_erase_middle(void *t_ctx) {
+  struct ints *ints = t_ctx;
+  while (!rda_empty(ints->m_arr)) {
+    rda_erase(ints->m_arr, rda_size(ints->m_arr) / 2, 1);
+  }
+  bench_clobber();
+  rda_free(ints->m_arr, ints->m_allocator);
+  if (ints->m_allocator == &arena_allocator) {
+    arena_reset(&bench_arena);
+  }
+}
+
+int main() {
+  struct ints ints = {.m_allocator = &libc_allocator};
+  bench_run("rda", "push_back", "rda/libc", PUSH_COUNT, NULL, run_push_back,
+            &ints);
+  bench_run("rda", "insert_middle", "rda/libc", SHIFT_COUNT, NULL,
+            run_insert_middle, &ints);
+  bench_run("rda", "erase_middle", "rda/libc", SHIFT_COUNT, setup_erase,
+            run_erase_middle, &ints);
+  ints.m_allocator = &arena_allocator;
+  bench_run("rda", "push_back", "rda/arena", PUSH_COUNT, NULL, run_push_back,
+            &ints);
+  bench_run("rda", "insert_middle", "rda/arena", SHIFT_COUNT, NULL,
+            run_insert_middle, &ints);
+  bench_run("rda", "erase_middle", "rda/arena", SHIFT_COUNT, setup_erase,
+            run_erase_middle, &ints);
+  arena_free(&bench_arena);
+}
@@ -0,0 +1,91 @@
+// rstr_append_str with libc and with an arena behind the allocator, then
+// reading a 32 MB text file with rstr_getstream and rstr_getline. std.cpp
+// does the same with std::string, std::ifstream and std::getline.
+
+#include "bench.h"
+
+#include "bench_alloc.h"
+#include "../rit_str.h"
+
+#define APPEND_COUNT (1 << 20)
+#define WORD_COUNT 4096
+#define FILE_SIZE (32 << 20)
+
+struct strings {
+  rsv m_words[WORD_COUNT];
+  rstr_allocator *m_allocator;
+  FILE *m_file;
+  size_t m_line_count;
+};
+
+static void run_append_str(void *t_ctx) {
+  struct strings *strings = t_ctx;
+  struct rstr str;
+  rstr_init(&str, 0, strings->m_allocator);
+  for (size_t i = 0; i < APPEND_COUNT; i++) {
+    rstr_append_str(&str, strings->m_words[i % WORD_COUNT],
+                    strings->m_allocator);
+  }
+  bench_sink(rstr_size(&str));
+  rstr_free(&str, strings->m_allocator);
+  if (strings->m_allocator == &arena_allocator) {
+    arena_reset(&bench_arena);
+  }
+}
+
+static void setup_read(void *t_ctx) {
+  struct strings *strings = t_ctx;
+  rewind(strings->m_file);
+}
+
+static void run_getstream(void *t_ctx) {
+  struct strings *strings = t_ctx;
+  struct rstr str;
+  rstr_init(&str, 0, strings->m_allocator);
+  rstr_getstream(strings->m_file, &str, strings->m_allocator);
+  bench_sink(rstr_size(&str));
+  rstr_free(&str, strings->m_allocator);
+}
+
+static void run_getline(void *t_ctx) {
+  struct strings *strings = t_ctx;
+  struct rstr line;
+  rstr_init(&line, 0, strings->m_allocator);
+  size_t bytes = 0;
+  while (rstr_getline(strings->m_file, &line, strings->m_allocator)) {
+    bytes += rstr_size(&line);
+    rstr_clear(&line);
+  }
+  bench_sink(bytes);
+  rstr_free(&line, strings->m_allocator);
+}
+
+int main() {
+  static struct strings strings = {.m_allocator = &libc_allocator};
+  static char letters[WORD_COUNT * 24];
+  size_t sizes[WORD_COUNT];
+  bench_words(letters, sizes, WORD_COUNT);
+  for (size_t i = 0, offset = 0; i < WORD_COUNT; i++) {
+    strings.m_words[i] = (rsv){.m_size = sizes[i], .m_str = letters + offset};
+    offset += sizes[i];
+  }
+  strings.m_file = tmpfile();
+  if (!strings.m_file) {
+    fprintf(stderr, "Error: can't create a temporary file\n");
+    return EXIT_FAILURE;
+  }
+  bench_write_text(strings.m_file, letters, sizes, WORD_COUNT, FILE_SIZE);
+
+  bench_run("rstr", "append_str", "rstr/libc", APPEND_COUNT, NULL,
+            run_append_str, &strings);
+  strings.m_allocator = &arena_allocator;
+  bench_run("rstr", "append_str", "rstr/arena", APPEND_COUNT, NULL,
+            run_append_str, &strings);
+  strings.m_allocator = &libc_allocator;
+  bench_run("rstr", "getstream", "rstr", FILE_SIZE, setup_read, run_getstream,
+            &strings);
+  bench_run("rstr", "getline", "rstr", FILE_SIZE, setup_read, run_getline,
+            &strings);
+  fclose(strings.m_file);
+  arena_free(&bench_arena);
+}
@@ -0,0 +1,75 @@
+// Throughput of rsv_hash() for key lengths from 4 bytes to 4 KB, next to the
+// FNV-1a loop it replaces. The results are per hash, the bytes per second
+// follow from the key length in the name.
+
+#include "bench.h"
+
+#include "../rit_str.h"
+
+#define KEY_COUNT 1024
+#define BYTES_PER_RUN (64 * 1024 * 1024)
+
+struct keys {
+  char *m_buffer;
+  size_t m_key_size;
+  size_t m_rounds;
+};
+
+static uint64_t fnv1a(rsv t_rsv) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < rsv_size(t_rsv); i++) {
+    hash ^= (unsigned char)rsv_data(t_rsv)[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+static void run_rsv_hash(void *t_ctx) {
+  struct keys *keys = t_ctx;
+  // The hashes are summed, so the compiler can't drop the calls
+  uint64_t sum = 0;
+  for (size_t round = 0; round < keys->m_rounds; round++) {
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+      rsv key = {.m_size = keys->m_key_size,
+                 .m_str = keys->m_buffer + i * 61 % 4096};
+      sum += rsv_hash(key);
+    }
+  }
+  bench_sink(sum);
+}
+
+static void run_fnv1a(void *t_ctx) {
+  struct keys *keys = t_ctx;
+  uint64_t sum = 0;
+  for (size_t round = 0; round < keys->m_rounds; round++) {
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+      rsv key = {.m_size = keys->m_key_size,
+                 .m_str = keys->m_buffer + i * 61 % 4096};
+      sum += fnv1a(key);
+    }
+  }
+  bench_sink(sum);
+}
+
+int main() {
+  // Keys start at different offsets of a random buffer, so they are not all
+  // aligned the same way
+  size_t buffer_size = KEY_COUNT * 64 + 4096;
+  struct keys keys = {.m_buffer = malloc(buffer_size)};
+  srand(1);
+  for (size_t i = 0; i < buffer_size; i++) {
+    keys.m_buffer[i] = (char)rand();
+  }
+
+  for (size_t key_size = 4; key_size <= 4096; key_size *= 2) {
+    char name[32];
+    snprintf(name, sizeof(name), "bytes_%zu", key_size);
+    keys.m_key_size = key_size;
+    keys.m_rounds = BYTES_PER_RUN / (key_size * KEY_COUNT) + 1;
+    size_t hashes = keys.m_rounds * KEY_COUNT;
+    bench_run("rsv_hash", name, "rsv_hash", hashes, NULL, run_rsv_hash,
+              &keys);
+    bench_run("rsv_hash", name, "fnv1a", hashes, NULL, run_fnv1a, &keys);
+  }
+  free(keys.m_buffer);
+}
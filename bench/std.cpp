@@ -0,0 +1,157 @@
+// The C++ standard library doing what arena.c, rda.c and rstr.c do, with the
+// same sizes and the same group and name, so the results line up.
+
+#include "bench.h"
+
+#include <fstream>
+#include <memory_resource>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#define OBJECT_COUNT (1 << 20)
+#define PUSH_COUNT (1 << 20)
+#define SHIFT_COUNT (1 << 14)
+#define APPEND_COUNT (1 << 20)
+#define WORD_COUNT 4096
+#define FILE_SIZE (32 << 20)
+
+static inline size_t object_size(size_t t_index) {
+  return 16 + (t_index * 7 % 8) * 8;
+}
+
+static std::vector<void *> ptrs(OBJECT_COUNT);
+static std::vector<std::string> words;
+static std::string path;
+static std::ifstream file;
+
+int main() {
+  bench_run(
+      "alloc", "small_objects", "new/delete", OBJECT_COUNT, nullptr,
+      [](void *) {
+        for (size_t i = 0; i < OBJECT_COUNT; i++) {
+          ptrs[i] = ::operator new(object_size(i));
+          *(size_t *)ptrs[i] = i;
+        }
+        bench_clobber();
+        for (size_t i = 0; i < OBJECT_COUNT; i++) {
+          ::operator delete(ptrs[i]);
+        }
+      },
+      nullptr);
+  // The memory of the resource is given back to its buffer on release(), like
+  // arena_reset()
+  static std::vector<char> buffer(OBJECT_COUNT * 80);
+  static std::pmr::monotonic_buffer_resource resource(buffer.data(),
+                                                      buffer.size());
+  bench_run(
+      "alloc", "small_objects", "std::pmr::monotonic", OBJECT_COUNT, nullptr,
+      [](void *) {
+        for (size_t i = 0; i < OBJECT_COUNT; i++) {
+          ptrs[i] = resource.allocate(object_size(i), alignof(size_t));
+          *(size_t *)ptrs[i] = i;
+        }
+        bench_clobber();
+        resource.release();
+      },
+      nullptr);
+
+  bench_run(
+      "rda", "push_back", "std::vector", PUSH_COUNT, nullptr,
+      [](void *) {
+        std::vector<int> arr;
+        for (int k = 0; k < PUSH_COUNT; k++) {
+          arr.push_back(k);
+        }
+        bench_sink((uint64_t)arr.back());
+      },
+      nullptr);
+  bench_run(
+      "rda", "insert_middle", "std::vector", SHIFT_COUNT, nullptr,
+      [](void *) {
+        std::vector<int> arr;
+        for (int k = 0; k < SHIFT_COUNT; k++) {
+          arr.insert(arr.begin() + arr.size() / 2, k);
+        }
+        bench_sink((uint64_t)arr.front());
+      },
+      nullptr);
+  static std::vector<int> erased;
+  bench_run(
+      "rda", "erase_middle", "std::vector", SHIFT_COUNT,
+      [](void *) {
+        erased.clear();
+        erased.shrink_to_fit();
+        for (int k = 0; k < SHIFT_COUNT; k++) {
+          erased.push_back(k);
+        }
+      },
+      [](void *) {
+        while (!erased.empty()) {
+          erased.erase(erased.begin() + erased.size() / 2);
+        }
+        bench_clobber();
+      },
+      nullptr);
+
+  static char letters[WORD_COUNT * 24];
+  static size_t sizes[WORD_COUNT];
+  bench_words(letters, sizes, WORD_COUNT);
+  for (size_t i = 0, offset = 0; i < WORD_COUNT; i++) {
+    words.emplace_back(letters + offset, sizes[i]);
+    offset += sizes[i];
+  }
+  bench_run(
+      "rstr", "append_str", "std::string", APPEND_COUNT, nullptr,
+      [](void *) {
+        std::string str;
+        for (size_t i = 0; i < APPEND_COUNT; i++) {
+          str += words[i % WORD_COUNT];
+        }
+        bench_sink(str.size());
+      },
+      nullptr);
+
+  // std::ifstream needs a path, the file is removed once it is open
+  char name[] = "/tmp/bench_XXXXXX";
+  int fd = mkstemp(name);
+  FILE *out = fd < 0 ? nullptr : fdopen(fd, "wb");
+  if (!out) {
+    fprintf(stderr, "Error: can't create a temporary file\n");
+    return EXIT_FAILURE;
+  }
+  bench_write_text(out, letters, sizes, WORD_COUNT, FILE_SIZE);
+  fclose(out);
+  file.open(name, std::ios::binary);
+  unlink(name);
+  bench_run(
+      "rstr", "getstream", "std::string", FILE_SIZE,
+      [](void *) {
+        file.clear();
+        file.seekg(0);
+      },
+      [](void *) {
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        bench_sink(stream.str().size());
+      },
+      nullptr);
+  bench_run(
+      "rstr", "getline", "std::string", FILE_SIZE,
+      [](void *) {
+        file.clear();
+        file.seekg(0);
+      },
+      [](void *) {
+        std::string line;
+        size_t bytes = 0;
+        while (std::getline(file, line)) {
+          bytes += line.size();
+        }
+        bench_sink(bytes);
+      },
+      nullptr);
+}
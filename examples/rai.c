@@ -0,0 +1,60 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_aio.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main(int argc, char **argv) {
+  const char *default_paths[] = {"rai.c", "input.txt"};
+  const char **paths = argc > 1 ? (const char **)argv + 1 : default_paths;
+  size_t path_count = argc > 1 ? (size_t)argc - 1 : 2;
+
+  // 4 buffers of 4 KiB, the reads of all the files share them
+  struct rai_reader reader;
+  rai_init(&reader, 4096, 4, &allocator);
+  const char *backends[] = {"pread on this thread", "pread on a thread",
+                            "io_uring"};
+  printf("reading with %s\n", backends[rai_backend(&reader)]);
+
+  rda_struct(size_t) lines;
+  rda_init(lines, 0, sizeof(size_t), &allocator);
+  for (size_t i = 0; i < path_count; i++) {
+    rai_open(&reader, paths[i]);
+    rda_push_back(lines, 0, &allocator);
+  }
+  // The next blocks are read while this one is counted, giving it back
+  // starts another read into its buffer
+  struct rai_block block;
+  while (rai_next(&reader, &block)) {
+    rda_at(lines, block.m_file) += rsv_count_char(block.m_data, '\n');
+    rai_release(&reader, &block);
+  }
+  for (size_t i = 0; i < path_count; i++) {
+    printf("%s: %zu lines%s\n", paths[i], rda_at(lines, i),
+           rai_file_error(&reader, i) ? ", failed to read" : "");
+  }
+
+  rda_free(lines, &allocator);
+  rai_free(&reader);
+}
@@ -0,0 +1,72 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_bitset.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main() {
+  // Every flag takes a single bit, instead of a whole byte like
+  // `rda_struct(bool)` would.
+  rbs(primes, 100, &allocator);
+  rbs_set_all(&primes);
+  rbs_reset(&primes, 0);
+  rbs_reset(&primes, 1);
+  for (size_t i = 2; i * i < rbs_size(&primes); i++) {
+    if (rbs_test(&primes, i)) {
+      for (size_t j = i * i; j < rbs_size(&primes); j += i) {
+        rbs_reset(&primes, j);
+      }
+    }
+  }
+  printf("primes below %zu: ", rbs_size(&primes));
+  rbs_for_each_set(i, &primes) { printf("%zu ", i); }
+  printf("\ncount: %zu\n", rbs_count(&primes));
+
+  rbs(odd, 100, &allocator);
+  for (size_t i = 1; i < rbs_size(&odd); i += 2) {
+    rbs_set(&odd, i);
+  }
+  // Word level operations, 64 bits at a time
+  rbs_andnot(&odd, &primes);
+  printf("odd non primes below 20: ");
+  for (size_t i = rbs_find_first(&odd); i < 20; i = rbs_find_next(&odd, i + 1)) {
+    printf("%zu ", i);
+  }
+  putchar('\n');
+
+  // Rank and select in constant time, after building the rank directory
+  struct rbs_rank rank = {};
+  rbs_rank_build(&rank, &primes, &allocator);
+  printf("primes below 50: %zu\n", rbs_rank_query(&rank, &primes, 50));
+  printf("10th prime: %zu\n", rbs_select(&rank, &primes, 9));
+  rbs_rank_free(&rank, &allocator);
+
+  rbs_resize(&primes, 1000, false, &allocator);
+  rbs_push_back(&primes, true, &allocator);
+  printf("size: %zu, capacity: %zu, count: %zu\n", rbs_size(&primes),
+         rbs_capacity(&primes), rbs_count(&primes));
+
+  rbs_free(&primes, &allocator);
+  rbs_free(&odd, &allocator);
+}
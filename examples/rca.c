@@ -0,0 +1,65 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_varint_arr.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main() {
+  // Posting lists are sorted, so they compress well as deltas.
+  rca(multiples_of_3, &allocator);
+  rca(multiples_of_5, &allocator);
+  for (uint64_t i = 0; i < 100000; i++) {
+    rca_push_back(&multiples_of_3, i * 3, &allocator);
+    rca_push_back(&multiples_of_5, i * 5, &allocator);
+  }
+  printf("values: %zu, bytes: %zu (%zu as uint64_t)\n",
+         rca_size(&multiples_of_3), rca_bytes(&multiples_of_3),
+         rca_size(&multiples_of_3) * sizeof(uint64_t));
+  printf("value at index 1000: %llu\n",
+         (unsigned long long)rca_at(&multiples_of_3, 1000));
+
+  rca(multiples_of_15, &allocator);
+  rca_intersect(&multiples_of_15, &multiples_of_3, &multiples_of_5,
+                &allocator);
+  printf("multiples of 15 below 100: ");
+  rca_for_each(val, &multiples_of_15) {
+    if (val >= 100) {
+      break;
+    }
+    printf("%llu ", (unsigned long long)val);
+  }
+  putchar('\n');
+
+  // Skip whole blocks without decoding them
+  struct rca_iter it = rca_iter(&multiples_of_15);
+  uint64_t val;
+  if (rca_iter_skip_to(&it, 123456, &val)) {
+    printf("first multiple of 15 >= 123456: %llu\n", (unsigned long long)val);
+  }
+
+  rca_free(&multiples_of_3, &allocator);
+  rca_free(&multiples_of_5, &allocator);
+  rca_free(&multiples_of_15, &allocator);
+}
@@ -0,0 +1,47 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_mmap.h"
+
+typedef struct {
+  double x, y;
+} Vec2;
+
+int main() {
+  // The elements live in the file, growing the array grows the file. A file
+  // that already exists is loaded, this one is removed at the end.
+  const char *path = "/tmp/rda_mmap_points.rda";
+  struct rmm_file file = {};
+  rda_allocator allocator = rmm_allocator(&file);
+  rda_struct(Vec2) points = {};
+  rda_mmap_open(points, path, false, &file);
+  printf("points loaded from the file: %zu\n", rda_size(points));
+  for (int i = 0; i < 100; i++) {
+    rda_push_back(points, ((Vec2){(double)i, (double)i * 2}), &allocator);
+  }
+  // The size is only written to the header on sync or close
+  rda_mmap_close(points, &file);
+
+  // A read only open is usable immediately, nothing gets parsed or copied
+  struct rmm_file readonly_file = {};
+  rda_struct(Vec2) view = {};
+  rda_mmap_open(view, path, true, &readonly_file);
+  printf("size: %zu, capacity: %zu, last: (%lf, %lf)\n", rda_size(view),
+         rda_capacity(view), rda_back(view).x, rda_back(view).y);
+  rda_mmap_close(view, &readonly_file);
+  remove(path);
+
+  // Scan a text file in place, without reading it into a rstr first
+  struct rmm_view text_view;
+  rsv text = rmm_view_open(&text_view, "rda_mmap.c", RMM_ADVISE_SEQUENTIAL);
+  size_t line_count = 0;
+  for (const char *it = rsv_begin(text); it != rsv_end(text); it++) {
+    if (*it == '\n') {
+      line_count++;
+    }
+  }
+  printf("rda_mmap.c: %zu bytes, %zu lines, first line: %.*s\n",
+         rsv_size(text), line_count, 20, rsv_data(text));
+  rmm_view_close(&text_view);
+}
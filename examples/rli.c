@@ -0,0 +1,80 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_lines.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main() {
+  rsv log = rsv_lit("12:00:01 start\n"
+                    "12:00:02 connect db\n"
+                    "12:00:05 error: timeout\n"
+                    "12:00:06 retry\n"
+                    "12:00:07 done\n");
+
+  // One scan for the whole text, after that any line is a lookup away
+  struct rli index;
+  rli_build_parallel(&index, log, 4, &allocator);
+  printf("lines: %zu, line 3: %.*s\n", rli_count(&index),
+         rsv_fmt(rli_line(&index, 3)));
+
+  // From a match somewhere in the text back to its line
+  size_t offset = rsv_find(log, rsv_lit("error"), 0);
+  size_t line = rli_find(&index, offset);
+  printf("\"error\" is at byte %zu, on line %zu: %.*s\n", offset, line,
+         rsv_fmt(rli_line(&index, line)));
+
+  // Save the index, a later run could load it instead of scanning the text.
+  // A temporary file here, removed when it is closed.
+  char buf[256];
+  FILE *file = tmpfile();
+  struct rsr_writer writer;
+  rsr_writer_init(&writer, buf, sizeof(buf), rsr_file_write, file, true);
+  rli_write(&writer, &index);
+  if (!rsr_writer_flush(&writer)) {
+    fprintf(stderr, "Failed to write the index\n");
+  }
+  rli_free(&index, &allocator);
+
+  rewind(file);
+  struct rsr_reader reader;
+  rsr_reader_init(&reader, buf, sizeof(buf), rsr_file_read, file);
+  if (rli_read(&reader, &index, log, &allocator)) {
+    printf("loaded, last line: %.*s\n",
+           rsv_fmt(rli_line(&index, rli_count(&index) - 1)));
+  }
+
+  // The index only fits the text it was written for
+  rsv other = rsv_lit("this text has the same size as the log\n"
+                      "but its lines start at other places.\n"
+                      "see, right?\n");
+  rewind(file);
+  rsr_reader_init(&reader, buf, sizeof(buf), rsr_file_read, file);
+  struct rli wrong;
+  printf("index fits another text: %s\n",
+         rli_read(&reader, &wrong, other, &allocator) ? "yes" : "no");
+  fclose(file);
+
+  rli_free(&wrong, &allocator);
+  rli_free(&index, &allocator);
+}
@@ -0,0 +1,60 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_ALLOCATOR_IMPLEMENTATION
+#include "../arena_allocator.h"
+#include "../rit_dyn_arr.h"
+#include "../rit_match.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main() {
+  // The patterns are compiled once, the matcher lives in the arena
+  Arena arena = {nullptr, nullptr};
+  rda_struct(rsv) keywords;
+  rda_init(keywords, 0, sizeof(rsv), &allocator);
+  rda_push_back(keywords, rsv_lit("error"), &allocator);
+  rda_push_back(keywords, rsv_lit("timeout"), &allocator);
+  rda_push_back(keywords, rsv_lit("out"), &allocator);
+  rda_push_back(keywords, rsv_lit("refused"), &allocator);
+  struct rmt matcher = rmt_build(&arena, keywords);
+  rda_free(keywords, &allocator);
+
+  // One pass over every line finds all the keywords, overlapping ones too
+  rsv log = rsv_lit("12:00 ok\n"
+                    "12:01 error: read timeout\n"
+                    "12:02 error: connection refused\n");
+  struct rsv_split lines = rsv_split_char(log, '\n');
+  rsv line;
+  while (rsv_split_next(&lines, &line)) {
+    struct rmt_iter iter = rmt_iter(&matcher, line);
+    struct rmt_match match;
+    while (rmt_next(&iter, &match)) {
+      rsv keyword = rmt_pattern(&matcher, match.m_pattern);
+      printf("line '%.*s': keyword %zu '%.*s' at %zu\n", rsv_fmt(line),
+             match.m_pattern, rsv_fmt(keyword), match.m_offset);
+    }
+  }
+
+  arena_free(&arena);
+}
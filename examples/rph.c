@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_phash.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+static const rsv keywords[] = {
+    rsv_lit("break"),  rsv_lit("case"),   rsv_lit("char"),  rsv_lit("const"),
+    rsv_lit("do"),     rsv_lit("double"), rsv_lit("else"),  rsv_lit("enum"),
+    rsv_lit("float"),  rsv_lit("for"),    rsv_lit("if"),    rsv_lit("int"),
+    rsv_lit("return"), rsv_lit("sizeof"), rsv_lit("static"),
+    rsv_lit("struct"), rsv_lit("void"),   rsv_lit("while"),
+};
+
+// Run without arguments for a demo, or as `rph name key...` to write the
+// table of the given keys as C source to stdout
+int main(int argc, char **argv) {
+  struct rph table;
+  if (argc > 2) {
+    rda_struct(rsv) keys;
+    rda_init(keys, 0, sizeof(rsv), &allocator);
+    for (int i = 2; i < argc; i++) {
+      rda_push_back(keys, rsv_cstr(argv[i], strlen(argv[i])), &allocator);
+    }
+    rph_build(&table, keys.m_data, rda_size(keys), &allocator);
+    rph_write_c(stdout, &table, argv[1]);
+    rph_free(&table, &allocator);
+    rda_free(keys, &allocator);
+    return 0;
+  }
+
+  rph_build(&table, keywords, sizeof(keywords) / sizeof(keywords[0]),
+            &allocator);
+  struct rsv_split split = rsv_split_char(
+      rsv_lit("static int count ( void ) { for ( ;; ) return sizeof x ; }"),
+      ' ');
+  rsv token;
+  while (rsv_split_next(&split, &token)) {
+    size_t id = rph_find(&table, token);
+    if (id == RPH_NONE) {
+      printf("%-8.*s -\n", rsv_fmt(token));
+    } else {
+      printf("%-8.*s keyword %zu\n", rsv_fmt(token), id);
+    }
+  }
+
+  // The same table as constants, to include instead of building it
+  printf("\n");
+  rph_write_c(stdout, &table, "c_keywords");
+  rph_free(&table, &allocator);
+  return 0;
+}
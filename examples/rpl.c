@@ -0,0 +1,124 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_ALLOCATOR_IMPLEMENTATION
+#include "../arena_allocator.h"
+#include "../rit_pipeline.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+struct chunk_result {
+  size_t m_lines;
+  uint64_t m_total;
+  rsv m_max_line;
+};
+
+struct totals {
+  size_t m_chunks;
+  size_t m_lines;
+  uint64_t m_total;
+  uint64_t m_max;
+  rsv m_max_line;
+};
+
+// Runs on the worker threads, each line looks like "sensor-12,345"
+void *sum_chunk(void *t_ctx, size_t t_index, rsv t_chunk, Arena *t_arena) {
+  (void)t_ctx;
+  (void)t_index;
+  struct chunk_result *result =
+      arena_alloc_struct(t_arena, struct chunk_result);
+  *result = (struct chunk_result){};
+  uint64_t max = 0;
+  struct rsv_split lines = rsv_split_char(t_chunk, '\n');
+  rsv line;
+  while (rsv_split_next(&lines, &line)) {
+    size_t comma = rsv_find_char(line, ',', 0);
+    uint64_t val;
+    if (comma == RSV_NPOS ||
+        !rsv_parse_u64(rsv_substr(line, comma + 1, RSV_NPOS), &val)) {
+      continue;
+    }
+    result->m_lines++;
+    result->m_total += val;
+    if (val >= max) {
+      max = val;
+      result->m_max_line = line;
+    }
+  }
+  return result;
+}
+
+// Runs one chunk at a time and in order, so it needs no locking
+void merge_chunk(void *t_ctx, size_t t_index, rsv t_chunk, void *t_result) {
+  (void)t_index;
+  (void)t_chunk;
+  struct totals *totals = (struct totals *)t_ctx;
+  struct chunk_result *result = (struct chunk_result *)t_result;
+  uint64_t max = 0;
+  rsv max_line = result->m_max_line;
+  size_t comma = rsv_find_char(max_line, ',', 0);
+  if (comma != RSV_NPOS) {
+    rsv_parse_u64(rsv_substr(max_line, comma + 1, RSV_NPOS), &max);
+  }
+  totals->m_chunks++;
+  totals->m_lines += result->m_lines;
+  totals->m_total += result->m_total;
+  if (result->m_lines && max >= totals->m_max) {
+    totals->m_max = max;
+    totals->m_max_line = max_line;
+  }
+}
+
+int main() {
+  rstr(readings, RSV_NULL, &allocator);
+  for (uint64_t i = 0; i < 100000; i++) {
+    rstr_append_str(&readings, rsv_lit("sensor-"), &allocator);
+    rstr_append_u64(&readings, i % 97, &allocator);
+    rstr_push_back(&readings, ',', &allocator);
+    rstr_append_u64(&readings, (i * 7919) % 1000, &allocator);
+    rstr_push_back(&readings, '\n', &allocator);
+  }
+
+  // A rsv is cut into chunks in place, a mapped file from rmm_view_open()
+  // works the same way
+  struct totals totals = {};
+  struct rpl pipeline;
+  rpl_init(&pipeline, sum_chunk, merge_chunk, &totals, 4, 64 * 1024);
+  rpl_run(&pipeline, rsv_rstr(&readings), &allocator);
+  printf("chunks: %zu, lines: %zu, total: %llu, last max: %.*s\n",
+         totals.m_chunks, totals.m_lines, (unsigned long long)totals.m_total,
+         rsv_fmt(totals.m_max_line));
+
+  // A stream is read a chunk ahead of the workers, the chunks are copies, so
+  // a rsv into them only lives until the merge returns
+  FILE *file = tmpfile();
+  fwrite(rstr_data(&readings), 1, rstr_size(&readings), file);
+  rewind(file);
+  totals = (struct totals){};
+  rpl_run_stream(&pipeline, file, &allocator);
+  printf("chunks: %zu, lines: %zu, total: %llu\n", totals.m_chunks,
+         totals.m_lines, (unsigned long long)totals.m_total);
+  fclose(file);
+
+  rstr_free(&readings, &allocator);
+}
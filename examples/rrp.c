@@ -0,0 +1,62 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_ALLOCATOR_IMPLEMENTATION
+#include "../arena_allocator.h"
+#include "../rit_rope.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rstr_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main() {
+  // Every node and every inserted string lives in the arena
+  Arena arena = {nullptr, nullptr};
+  struct rrp rope = rrp(&arena);
+
+  // Large text can be referenced instead of copied, it must outlive the rope
+  rsv document = rsv_lit("The quick fox jumps over the dog.");
+  rrp_insert_ref(&rope, 0, document);
+  rrp_insert(&rope, 10, rsv_lit("brown "));
+  rrp_insert(&rope, rrp_size(&rope) - 4, rsv_lit("lazy "));
+  rrp_erase(&rope, 0, 4);
+  rrp_append(&rope, rsv_lit(" The end."));
+  printf("size: %zu, rope[0]: %c\n", rrp_size(&rope), rrp_at(&rope, 0));
+
+  // The text can be read piece by piece, without copying it
+  struct rrp_iter iter = rrp_iter(&rope, 0, rrp_size(&rope));
+  rsv chunk;
+  while (rrp_iter_next(&iter, &chunk)) {
+    printf("[%.*s]", rsv_fmt(chunk));
+  }
+  printf("\n");
+
+  // Or copied into a rstr when a contiguous string is needed
+  rstr(flat, RSV_NULL, &allocator);
+  rrp_flatten(&rope, &flat, &allocator);
+  rstr_println(&flat);
+  rstr_clear(&flat);
+  rrp_substr(&rope, 6, 10, &flat, &allocator);
+  rstr_println(&flat);
+
+  rstr_free(&flat, &allocator);
+  arena_free(&arena);
+}
@@ -0,0 +1,68 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_sort.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main() {
+  rda_struct(rsv) words;
+  rda_init(words, 0, sizeof(rsv), &allocator);
+  struct rsv_split split = rsv_split_char(
+      rsv_lit("banana apple band bandana apple ban banana can candle"), ' ');
+  rsv word;
+  while (rsv_split_next(&split, &word)) {
+    rda_push_back(words, word, &allocator);
+  }
+
+  // Only the rsv move, the characters stay in the literal
+  rso_sort_rda(words, &allocator);
+  printf("sorted:");
+  rda_for_each(it, words) { printf(" %.*s", rsv_fmt(*it)); }
+  printf("\n");
+
+  // The common prefixes come for free while removing the repeated words,
+  // enough to store each word as what it adds to the one before it
+  size_t lcp[9];
+  size_t count = rso_dedup(words.m_data, rda_size(words), lcp);
+  printf("front coded:");
+  for (size_t i = 0; i < count; i++) {
+    printf(" %zu:%.*s", lcp[i],
+           rsv_fmt(rsv_substr(rda_at(words, i), lcp[i], RSV_NPOS)));
+  }
+  printf("\n");
+
+  // With more strings, the buckets of the first character can be sorted on
+  // a few threads
+  rda_struct(rsv) many;
+  rda_init(many, 0, sizeof(rsv), &allocator);
+  for (size_t i = 0; i < 1000; i++) {
+    rda_push_back(many, rda_at(words, (i * 5) % count), &allocator);
+  }
+  rso_sort_parallel(many.m_data, rda_size(many), 4, &allocator);
+  printf("first: %.*s, last: %.*s\n", rsv_fmt(rda_at(many, 0)),
+         rsv_fmt(rda_back(many)));
+
+  rda_free(many, &allocator);
+  rda_free(words, &allocator);
+}
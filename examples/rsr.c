@@ -0,0 +1,101 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_dyn_arr.h"
+#include "../rit_serial.h"
+#include "../rit_str.h"
+
+#define ARENA_ALLOCATOR_IMPLEMENTATION
+#include "../arena_allocator.h"
+
+#define nullptr (void *)0
+
+void *arena_allocator_alloc(void *t_arena, size_t t_size_in_bytes) {
+  return arena_alloc((Arena *)t_arena, t_size_in_bytes);
+}
+void arena_allocator_free(void *t_arena, void *t_ptr) {
+  (void)t_arena;
+  (void)t_ptr;
+}
+void *arena_allocator_realloc(void *t_arena, void *t_old_ptr,
+                              size_t t_old_size_in_bytes,
+                              size_t t_new_size_in_bytes) {
+  return arena_realloc((Arena *)t_arena, t_old_ptr, t_old_size_in_bytes,
+                       t_new_size_in_bytes);
+}
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+Arena arena = {nullptr, nullptr};
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+rda_allocator arena_allocator = {arena_allocator_alloc, arena_allocator_free,
+                                 arena_allocator_realloc, &arena};
+
+int main() {
+  rda(uint64_t, ids, 0, &allocator);
+  for (uint64_t i = 0; i < 1000; i++) {
+    rda_push_back(ids, i * i, &allocator);
+  }
+  rstr(name, rsv_lit("checkpoint"), &allocator);
+  rsv words[] = {rsv_lit("Hello"), rsv_lit("World"), rsv_lit("from"),
+                 rsv_lit("C")};
+
+  // The writer goes through a small caller provided buffer, big payloads
+  // skip it and are written directly.
+  char buf[256];
+  // A temporary file, removed when it is closed
+  FILE *file = tmpfile();
+  struct rsr_writer writer;
+  rsr_writer_init(&writer, buf, sizeof(buf), rsr_file_write, file, true);
+  rsr_write_rda(&writer, ids);
+  rsr_write_rstr(&writer, &name);
+  rsr_write_rsv_arr(&writer, words, sizeof(words) / sizeof(words[0]));
+  if (!rsr_writer_flush(&writer)) {
+    fprintf(stderr, "Failed to write the checkpoint\n");
+  }
+
+  rewind(file);
+  struct rsr_reader reader;
+  rsr_reader_init(&reader, buf, sizeof(buf), rsr_file_read, file);
+  // Load the array into an arena, the elements are copied in bulk
+  rda_struct(uint64_t) loaded_ids = {};
+  rsr_read_rda(&reader, loaded_ids, &arena_allocator);
+  rstr(loaded_name, RSV_NULL, &allocator);
+  rsr_read_rstr(&reader, &loaded_name, &allocator);
+  size_t word_count = 0;
+  rsv *loaded_words = rsr_read_rsv_arr(&reader, &word_count, &arena_allocator);
+  fclose(file);
+  if (rsr_reader_error(&reader)) {
+    fprintf(stderr, "The checkpoint is corrupted\n");
+    return 1;
+  }
+
+  printf("ids: %zu, last: %llu\n", rda_size(loaded_ids),
+         (unsigned long long)rda_back(loaded_ids));
+  printf("name: %.*s\n", rstr_fmt(&loaded_name));
+  for (size_t i = 0; i < word_count; i++) {
+    rsv_println(loaded_words[i]);
+  }
+
+  rda_free(ids, &allocator);
+  rstr_free(&name, &allocator);
+  rstr_free(&loaded_name, &allocator);
+  arena_free(&arena);
+}
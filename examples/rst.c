@@ -0,0 +1,62 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../rit_strtab.h"
+
+#define nullptr (void *)0
+
+void *libc_malloc(void *t_ctx, size_t t_size_in_bytes) {
+  (void)t_ctx;
+  return malloc(t_size_in_bytes);
+}
+
+void libc_free(void *t_ctx, void *t_ptr) {
+  (void)t_ctx;
+  free(t_ptr);
+}
+
+void *libc_realloc(void *t_ctx, void *t_old_ptr, size_t t_old_size_in_bytes,
+                   size_t t_new_size_in_bytes) {
+  (void)t_ctx;
+  (void)t_old_size_in_bytes;
+  return realloc(t_old_ptr, t_new_size_in_bytes);
+}
+
+rda_allocator allocator = {libc_malloc, libc_free, libc_realloc, nullptr};
+
+int main() {
+  // All the characters go into one buffer, however many strings there are
+  rst(column, &allocator);
+  struct rsv_split cities =
+      rsv_split_char(rsv_lit("Oslo,Lima,Bern,Oslo,Accra,Lima,Oslo"), ',');
+  rsv city;
+  while (rsv_split_next(&cities, &city)) {
+    rst_push_back(&column, city, &allocator);
+  }
+  printf("strings: %zu, bytes: %zu, column[1]: %.*s\n", rst_size(&column),
+         rst_bytes(&column), rsv_fmt(rst_at(&column, 1)));
+
+  // Sorting only produces the order, the strings stay where they are
+  size_t perm[7];
+  rst_sort(&column, perm, &allocator);
+  printf("sorted:");
+  for (size_t i = 0; i < rst_size(&column); i++) {
+    printf(" %.*s", rsv_fmt(rst_at(&column, perm[i])));
+  }
+  printf("\n");
+
+  // Dedup keeps the first of the equal strings, ids maps the old indices to
+  // the new ones, which turns the column into a dictionary and codes
+  size_t ids[7];
+  rst_dedup(&column, ids, &allocator);
+  printf("dictionary:");
+  rst_for_each(str, &column) { printf(" %.*s", rsv_fmt(str)); }
+  printf("\ncodes:");
+  for (size_t i = 0; i < 7; i++) {
+    printf(" %zu", ids[i]);
+  }
+  printf("\n");
+
+  rst_free(&column, &allocator);
+}
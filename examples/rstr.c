@@ -71,6 +71,49 @@ int main() {
   rstr_getstream(file, &str4, &allocator);
   printf("str4 (from input.txt): %.*s", rstr_fmt(&str4));
 
+  // Read input.txt again, one line at a time, without copying every line
+  rewind(file);
+  struct rstr_reader reader;
+  rstr_reader_init(&reader, file, DEFAULT_READER_CAP, &allocator);
+  rsv line;
+  size_t line_count = 0;
+  while (rstr_reader_getline(&reader, &line, &allocator)) {
+    printf("line %zu: %.*s\n", ++line_count, rsv_fmt(line));
+  }
+  rstr_reader_free(&reader, &allocator);
+  fclose(file);
+
+  // Formatting appends right into the string, no stack buffers needed
+  rstr(report, RSV_NULL, &allocator);
+  rstr_append_str(&report, rsv_lit("lines: "), &allocator);
+  rstr_append_u64(&report, line_count, &allocator);
+  rstr_append_str(&report, rsv_lit(", delta: "), &allocator);
+  rstr_append_i64(&report, -1234567, &allocator);
+  rstr_append_str(&report, rsv_lit(", ratio: "), &allocator);
+  rstr_append_f64(&report, 0.1 + 0.2, &allocator);
+  rstr_append_str(&report, rsv_lit(", id: 0x"), &allocator);
+  rstr_append_hex(&report, 0xbeef, 8, &allocator);
+  rstr_appendf(&report, &allocator, ", %s: %5.2f%%", "load", 42.125);
+  rstr_println(&report);
+  rstr_free(&report, &allocator);
+
+  // Copies of a shared string only count references, the characters are
+  // copied when one of the copies changes
+  struct rstr_shared payload;
+  rstr_shared_init(&payload, rsv_lit("a large payload"), &allocator);
+  struct rstr_shared stage;
+  rstr_shared_copy(&stage, &payload);
+  printf("use count: %ld, same characters: %s\n",
+         rstr_shared_use_count(&payload),
+         rstr_shared_data(&stage) == rstr_shared_data(&payload) ? "true"
+                                                                : "false");
+  rstr_shared_replace(&stage, 2, 5, rsv_lit("small"), &allocator);
+  printf("payload: %.*s, stage: %.*s, use count: %ld\n",
+         rsv_fmt(rsv_rstr_shared(&payload)), rsv_fmt(rsv_rstr_shared(&stage)),
+         rstr_shared_use_count(&payload));
+  rstr_shared_free(&stage, &allocator);
+  rstr_shared_free(&payload, &allocator);
+
   rstr_free(&str, &allocator);
   rstr_free(&str2, &allocator);
   rstr_free(&str3, &allocator);
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../rit_dyn_arr.h"
 #include "../rit_str.h"
 
 #define nullptr (void *)0
@@ -44,6 +45,102 @@ int main() {
   rsv_println(sv);
   printf("%.*s\n", rsv_fmt(sv1));
   rsv_println(sv2);
+
+  // Searching returns an index, or RSV_NPOS when nothing was found
+  rsv log = rsv_lit("GET /index.html 200\nGET /missing 404\nPOST /form 200\n");
+  printf("lines: %zu\n", rsv_count_char(log, '\n'));
+  size_t pos = rsv_find(log, rsv_lit(" 404"), 0);
+  size_t line_begin = rsv_rfind_char(log, '\n', pos) + 1;
+  printf("first 404 at %zu, its line starts at %zu\n", pos, line_begin);
+  printf("last GET at %zu\n", rsv_rfind(log, rsv_lit("GET"), RSV_NPOS));
+  printf("first digit at %zu\n",
+         rsv_find_first_of(log, rsv_lit("0123456789"), 0));
+  if (rsv_find(log, rsv_lit("DELETE"), 0) == RSV_NPOS) {
+    printf("no DELETE requests\n");
+  }
+
+  // Splitting gives views into the original string, nothing is copied
+  struct rsv_split lines = rsv_split_char(log, '\n');
+  rsv line;
+  while (rsv_split_next(&lines, &line)) {
+    if (rsv_size(line) == 0) {
+      continue;
+    }
+    struct rsv_split fields = rsv_split_any(line, rsv_lit(" \t"));
+    rsv method;
+    rsv_split_next(&fields, &method);
+    printf("method: %.*s\n", rsv_fmt(method));
+  }
+
+  // Or all the pieces at once
+  rda_struct(rsv) cells;
+  rda_init(cells, 0, sizeof(rsv), &allocator);
+  struct rsv_split csv = rsv_split(rsv_lit("id, name, , email"), rsv_lit(", "));
+  rsv_split_collect(&csv, cells, &allocator);
+  for (size_t i = 0; i < rda_size(cells); i++) {
+    printf("cell %zu: '%.*s'\n", i, rsv_fmt(rda_at(cells, i)));
+  }
+  rda_free(cells, &allocator);
+
+  // Numbers are parsed in place, the return value is how much was read
+  rsv columns = rsv_lit("1718000000 -42 0.125 3.5e-3ms");
+  struct rsv_split numbers = rsv_split_char(columns, ' ');
+  rsv number;
+  uint64_t timestamp = 0;
+  int64_t delta = 0;
+  double ratio = 0, latency = 0;
+  rsv_split_next(&numbers, &number);
+  rsv_parse_u64(number, &timestamp);
+  rsv_split_next(&numbers, &number);
+  rsv_parse_i64(number, &delta);
+  rsv_split_next(&numbers, &number);
+  rsv_parse_f64(number, &ratio);
+  rsv_split_next(&numbers, &number);
+  size_t parsed = rsv_parse_f64(number, &latency);
+  printf("%llu %lld %g %g, unit: %.*s\n", (unsigned long long)timestamp,
+         (long long)delta, ratio, latency, (int)(rsv_size(number) - parsed),
+         rsv_data(number) + parsed);
+  // Hashes are stable across runs, use a random seed where keys can be chosen
+  // by an attacker
+  printf("hash: %016llx, seeded: %016llx\n",
+         (unsigned long long)rsv_hash(rsv_lit("key")),
+         (unsigned long long)rsv_hash_seeded(rsv_lit("key"), 0x5eed));
+  printf("rstr_hash(str) == rsv_hash(sv1): %s\n",
+         rstr_hash(&str) == rsv_hash(sv1) ? "true" : "false");
+
+  // UTF-8 is validated and decoded without copying
+  rsv text = rsv_lit("naïve café €5");
+  printf("valid: %s, bytes: %zu, code points: %zu\n",
+         rsv_utf8_validate(text) ? "true" : "false", rsv_size(text),
+         rsv_utf8_count(text));
+  struct rsv_utf8_iter code_points = rsv_utf8_iter(text);
+  uint32_t code_point;
+  while (rsv_utf8_next(&code_points, &code_point)) {
+    printf("U+%04X ", (unsigned)code_point);
+  }
+  printf("\n");
+  printf("\\xff valid: %s\n",
+         rsv_utf8_validate(rsv_lit("\xff")) ? "true" : "false");
+
+  // Header names are matched without copying or lower casing them first
+  rsv header = rsv_lit("  Content-Length:  42 \r\n");
+  rsv name = rsv_trim(rsv_substr(header, 0, rsv_find_char(header, ':', 0)));
+  rsv value = rsv_trim(rsv_substr(header, rsv_find_char(header, ':', 0) + 1,
+                                  RSV_NPOS));
+  printf("content-length: %s, value: '%.*s', starts with \"Content\": %s\n",
+         rsv_eq_ignore_case(name, rsv_lit("content-length")) ? "true"
+                                                              : "false",
+         rsv_fmt(value),
+         rsv_starts_with(name, rsv_lit("Content")) ? "true" : "false");
+  struct rstr lower;
+  rstr_init(&lower, 0, &allocator);
+  rstr_append_lower(&lower, name, &allocator);
+  printf("lower: %.*s, sorts after the name: %s\n", rstr_fmt(&lower),
+         rsv_cmp(rsv_rstr(&lower), name) > 0 ? "true" : "false");
+  rstr_to_upper(&lower);
+  printf("upper: %.*s\n", rstr_fmt(&lower));
+  rstr_free(&lower, &allocator);
+
   rstr_free(&str, &allocator);
   return 0;
 }
@@ -0,0 +1,728 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RAI_INTERNAL_DEF
+#define RAI_INTERNAL_DEF static
+#endif // RAI_INTERNAL_DEF
+
+#ifndef RIT_AIO_H_INCLUDED
+#define RIT_AIO_H_INCLUDED
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "rit_aio.h needs a POSIX system"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "rit_dyn_arr.h"
+#include "rit_str.h"
+
+// io_uring is used through its system calls, liburing is not needed. Define
+// RAI_NO_URING to always use the fallback.
+#if defined(__linux__) && !defined(RAI_NO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define _RAI_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+// Without io_uring the reads are done by a background thread, define
+// RAI_NO_THREADS to do them on the calling thread instead
+#if !defined(RAI_NO_THREADS)
+#define _RAI_THREADS
+#include <pthread.h>
+#endif
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+#define DEFAULT_RAI_BUF_SIZE ((size_t)1 << 20)
+#define DEFAULT_RAI_BUF_COUNT 8
+
+/// @brief How the reads are done, see `rai_backend()`.
+enum rai_backend {
+  RAI_BACKEND_SYNC = 0,
+  RAI_BACKEND_THREAD = 1,
+  RAI_BACKEND_URING = 2,
+};
+
+/// @internal
+enum _rai_buf_state {
+  _RAI_BUF_FREE,
+  // A read was submitted
+  _RAI_BUF_READING,
+  // Read, waiting for the blocks before it in the file to be handed out
+  _RAI_BUF_READY,
+  // Handed out, until `rai_release()`
+  _RAI_BUF_HELD,
+};
+
+/// @internal
+struct _rai_file {
+  int m_fd;
+  bool m_owned;
+  bool m_error;
+  uint64_t m_size;
+  // The offset of the next block to read, and to hand out
+  uint64_t m_submitted;
+  uint64_t m_delivered;
+};
+
+/// @internal
+struct _rai_buf {
+  char *m_data;
+  enum _rai_buf_state m_state;
+  size_t m_file;
+  // Copied from the file, the background thread never touches the files
+  int m_fd;
+  uint64_t m_offset;
+  size_t m_size;
+  size_t m_filled;
+  // Result of the last read, the number of bytes or -errno
+  long m_result;
+  struct iovec m_iov;
+};
+
+/// @internal
+/// @brief Where the reads go, only the parts of the backend in use are set
+struct _rai_backend {
+  enum rai_backend m_kind;
+#ifdef _RAI_URING
+  int m_ring_fd;
+  void *m_sq_ptr;
+  size_t m_sq_size;
+  void *m_cq_ptr;
+  size_t m_cq_size;
+  struct io_uring_sqe *m_sqes;
+  size_t m_sqes_size;
+  unsigned *m_sq_tail;
+  unsigned *m_sq_mask;
+  unsigned *m_sq_array;
+  unsigned *m_cq_head;
+  unsigned *m_cq_tail;
+  unsigned *m_cq_mask;
+  struct io_uring_cqe *m_cqes;
+  unsigned m_unsubmitted;
+#endif // _RAI_URING
+  // Buffer indices waiting to be read, and read ones, both rings of the
+  // number of buffers
+  size_t *m_requests;
+  size_t m_request_head;
+  size_t m_request_count;
+  size_t *m_done;
+  size_t m_done_head;
+  size_t m_done_count;
+#ifdef _RAI_THREADS
+  pthread_t m_thread;
+  pthread_mutex_t m_lock;
+  pthread_cond_t m_request_cond;
+  pthread_cond_t m_done_cond;
+  bool m_stop;
+#endif // _RAI_THREADS
+};
+
+/// @brief Reads files in fixed size blocks, keeping a number of reads in
+/// flight while the blocks read so far are processed.
+///
+/// The reads of all the files opened go out at the same time, the blocks of
+/// one file are handed out in order.
+struct rai_reader {
+  rda_struct(struct _rai_file) m_files; // Do not modify this, this is private
+  struct _rai_buf *m_bufs;              // Do not modify this, this is private
+  size_t m_buf_count;                   // Do not modify this, this is private
+  size_t m_buf_size;                    // Do not modify this, this is private
+  size_t m_next_file;                   // Do not modify this, this is private
+  size_t m_reading;                     // Do not modify this, this is private
+  struct _rai_backend *m_backend;       // Do not modify this, this is private
+  rda_allocator *m_allocator;           // Do not modify this, this is private
+};
+
+/// @brief A block of a file, valid until it is given to `rai_release()`.
+struct rai_block {
+  rsv m_data;
+  // The index of the file, in the order they were opened
+  size_t m_file;
+  uint64_t m_offset;
+  size_t m_buf; // Do not modify this, this is private
+};
+
+/// @brief Get how the reads are done.
+static inline enum rai_backend rai_backend(struct rai_reader *t_reader) {
+  return t_reader->m_backend->m_kind;
+}
+
+/// @brief Check if reading a file failed, the blocks after the failure are
+/// not handed out.
+static inline bool rai_file_error(struct rai_reader *t_reader, size_t t_file) {
+  return rda_at(t_reader->m_files, t_file).m_error;
+}
+
+#ifdef _RAI_URING
+/// @internal
+/// @return false if io_uring is not available, the kernel is too old or it
+/// is blocked
+RAI_INTERNAL_DEF inline bool _rai_uring_init(struct _rai_backend *t_backend,
+                                             size_t t_entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = (int)syscall(__NR_io_uring_setup, (unsigned)t_entries, &params);
+  if (fd < 0) {
+    return false;
+  }
+  size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  size_t cq_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  // Newer kernels map both rings at once
+  bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single) {
+    sq_size = cq_size = sq_size > cq_size ? sq_size : cq_size;
+  }
+  void *sq_ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  void *cq_ptr = single || sq_ptr == MAP_FAILED
+                     ? sq_ptr
+                     : mmap(NULL, cq_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+  size_t sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes = cq_ptr == MAP_FAILED
+                   ? MAP_FAILED
+                   : mmap(NULL, sqes_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    if (sq_ptr != MAP_FAILED) {
+      munmap(sq_ptr, sq_size);
+    }
+    if (!single && cq_ptr != MAP_FAILED) {
+      munmap(cq_ptr, cq_size);
+    }
+    close(fd);
+    return false;
+  }
+  char *sq = (char *)sq_ptr;
+  char *cq = (char *)cq_ptr;
+  t_backend->m_ring_fd = fd;
+  t_backend->m_sq_ptr = sq_ptr;
+  t_backend->m_sq_size = sq_size;
+  t_backend->m_cq_ptr = single ? NULL : cq_ptr;
+  t_backend->m_cq_size = cq_size;
+  t_backend->m_sqes = (struct io_uring_sqe *)sqes;
+  t_backend->m_sqes_size = sqes_size;
+  t_backend->m_sq_tail = (unsigned *)(sq + params.sq_off.tail);
+  t_backend->m_sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+  t_backend->m_sq_array = (unsigned *)(sq + params.sq_off.array);
+  t_backend->m_cq_head = (unsigned *)(cq + params.cq_off.head);
+  t_backend->m_cq_tail = (unsigned *)(cq + params.cq_off.tail);
+  t_backend->m_cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+  t_backend->m_cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+  t_backend->m_kind = RAI_BACKEND_URING;
+  return true;
+}
+
+/// @internal
+static inline void _rai_uring_free(struct _rai_backend *t_backend) {
+  munmap(t_backend->m_sqes, t_backend->m_sqes_size);
+  if (t_backend->m_cq_ptr) {
+    munmap(t_backend->m_cq_ptr, t_backend->m_cq_size);
+  }
+  munmap(t_backend->m_sq_ptr, t_backend->m_sq_size);
+  close(t_backend->m_ring_fd);
+}
+
+/// @internal
+static inline void _rai_uring_submit(struct _rai_backend *t_backend,
+                                     struct _rai_buf *t_buf, size_t t_index) {
+  // Only this thread writes the tail, the kernel reads it
+  unsigned tail = *t_backend->m_sq_tail;
+  unsigned index = tail & *t_backend->m_sq_mask;
+  struct io_uring_sqe *sqe = &t_backend->m_sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  // READV works since the first io_uring kernels, READ needs 5.6
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = t_buf->m_fd;
+  sqe->addr = (uint64_t)(uintptr_t)&t_buf->m_iov;
+  sqe->len = 1;
+  sqe->off = t_buf->m_offset + t_buf->m_filled;
+  sqe->user_data = t_index;
+  t_backend->m_sq_array[index] = index;
+  __atomic_store_n(t_backend->m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+  t_backend->m_unsubmitted++;
+}
+
+/// @internal
+/// @brief Submit the queued reads and wait for at least t_wait_for of them
+/// @return false on an error of the ring itself
+static inline bool _rai_uring_enter(struct _rai_backend *t_backend,
+                                    unsigned t_wait_for) {
+  while (t_backend->m_unsubmitted || t_wait_for) {
+    long ret = syscall(__NR_io_uring_enter, t_backend->m_ring_fd,
+                       t_backend->m_unsubmitted, t_wait_for,
+                       t_wait_for ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      return false;
+    }
+    t_backend->m_unsubmitted -= (unsigned)ret;
+    if (t_wait_for) {
+      break;
+    }
+  }
+  return true;
+}
+#endif // _RAI_URING
+
+#ifdef _RAI_THREADS
+/// @internal
+/// @brief The background thread, reads the requested buffers in order
+static inline void *_rai_thread(void *t_reader) {
+  struct rai_reader *reader = (struct rai_reader *)t_reader;
+  struct _rai_backend *backend = reader->m_backend;
+  pthread_mutex_lock(&backend->m_lock);
+  for (;;) {
+    while (!backend->m_request_count && !backend->m_stop) {
+      pthread_cond_wait(&backend->m_request_cond, &backend->m_lock);
+    }
+    if (backend->m_stop) {
+      break;
+    }
+    size_t index = backend->m_requests[backend->m_request_head];
+    backend->m_request_head =
+        (backend->m_request_head + 1) % reader->m_buf_count;
+    backend->m_request_count--;
+    struct _rai_buf *buf = &reader->m_bufs[index];
+    pthread_mutex_unlock(&backend->m_lock);
+    ssize_t result = pread(buf->m_fd, buf->m_data + buf->m_filled,
+                           buf->m_size - buf->m_filled,
+                           (off_t)(buf->m_offset + buf->m_filled));
+    buf->m_result = result < 0 ? -errno : (long)result;
+    pthread_mutex_lock(&backend->m_lock);
+    backend->m_done[(backend->m_done_head + backend->m_done_count) %
+                    reader->m_buf_count] = index;
+    backend->m_done_count++;
+    pthread_cond_signal(&backend->m_done_cond);
+  }
+  pthread_mutex_unlock(&backend->m_lock);
+  return NULL;
+}
+#endif // _RAI_THREADS
+
+/// @internal
+/// @brief Start reading the next block of the next file into a free buffer
+static inline void _rai_submit(struct rai_reader *t_reader, size_t t_index) {
+  struct _rai_backend *backend = t_reader->m_backend;
+  struct _rai_buf *buf = &t_reader->m_bufs[t_index];
+  buf->m_iov = (struct iovec){.iov_base = buf->m_data + buf->m_filled,
+                              .iov_len = buf->m_size - buf->m_filled};
+  buf->m_state = _RAI_BUF_READING;
+  t_reader->m_reading++;
+#ifdef _RAI_URING
+  if (backend->m_kind == RAI_BACKEND_URING) {
+    _rai_uring_submit(backend, buf, t_index);
+    return;
+  }
+#endif // _RAI_URING
+#ifdef _RAI_THREADS
+  if (backend->m_kind == RAI_BACKEND_THREAD) {
+    pthread_mutex_lock(&backend->m_lock);
+  }
+#endif // _RAI_THREADS
+  backend->m_requests[(backend->m_request_head + backend->m_request_count) %
+                      t_reader->m_buf_count] = t_index;
+  backend->m_request_count++;
+#ifdef _RAI_THREADS
+  if (backend->m_kind == RAI_BACKEND_THREAD) {
+    pthread_cond_signal(&backend->m_request_cond);
+    pthread_mutex_unlock(&backend->m_lock);
+  }
+#endif // _RAI_THREADS
+}
+
+/// @internal
+/// @brief Give every free buffer the next block of one of the files, taking
+/// the files in turns
+static inline void _rai_fill(struct rai_reader *t_reader) {
+  size_t file_count = rda_size(t_reader->m_files);
+  for (size_t i = 0; i < t_reader->m_buf_count; i++) {
+    struct _rai_buf *buf = &t_reader->m_bufs[i];
+    if (buf->m_state != _RAI_BUF_FREE) {
+      continue;
+    }
+    size_t tried = 0;
+    for (; tried < file_count; tried++) {
+      size_t index = t_reader->m_next_file;
+      t_reader->m_next_file = (index + 1) % file_count;
+      struct _rai_file *file = &rda_at(t_reader->m_files, index);
+      if (file->m_submitted >= file->m_size || file->m_error) {
+        continue;
+      }
+      size_t left = (size_t)(file->m_size - file->m_submitted);
+      buf->m_file = index;
+      buf->m_fd = file->m_fd;
+      buf->m_offset = file->m_submitted;
+      buf->m_size = left < t_reader->m_buf_size ? left : t_reader->m_buf_size;
+      buf->m_filled = 0;
+      file->m_submitted += buf->m_size;
+      _rai_submit(t_reader, i);
+      break;
+    }
+    if (tried == file_count) {
+      return;
+    }
+  }
+}
+
+/// @internal
+/// @brief Handle a finished read, short reads are continued
+static inline void _rai_complete(struct rai_reader *t_reader, size_t t_index,
+                                 long t_result) {
+  struct _rai_buf *buf = &t_reader->m_bufs[t_index];
+  struct _rai_file *file = &rda_at(t_reader->m_files, buf->m_file);
+  t_reader->m_reading--;
+  // 0 before the end means the file got shorter since it was opened
+  if (t_result <= 0 || file->m_error) {
+    file->m_error = true;
+    buf->m_state = _RAI_BUF_FREE;
+    return;
+  }
+  buf->m_filled += (size_t)t_result;
+  if (buf->m_filled < buf->m_size) {
+    _rai_submit(t_reader, t_index);
+    return;
+  }
+  buf->m_state = _RAI_BUF_READY;
+}
+
+/// @internal
+/// @brief Wait for at least one read to finish
+/// @return false on an error of the io_uring
+static inline bool _rai_wait(struct rai_reader *t_reader) {
+  struct _rai_backend *backend = t_reader->m_backend;
+#ifdef _RAI_URING
+  if (backend->m_kind == RAI_BACKEND_URING) {
+    if (!_rai_uring_enter(backend, 1)) {
+      return false;
+    }
+    unsigned head = *backend->m_cq_head;
+    unsigned tail = __atomic_load_n(backend->m_cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      struct io_uring_cqe *cqe = &backend->m_cqes[head & *backend->m_cq_mask];
+      size_t index = (size_t)cqe->user_data;
+      long result = cqe->res;
+      // Free the entry before a continued read can need it
+      __atomic_store_n(backend->m_cq_head, head + 1, __ATOMIC_RELEASE);
+      _rai_complete(t_reader, index, result);
+    }
+    return _rai_uring_enter(backend, 0);
+  }
+#endif // _RAI_URING
+#ifdef _RAI_THREADS
+  if (backend->m_kind == RAI_BACKEND_THREAD) {
+    pthread_mutex_lock(&backend->m_lock);
+    while (!backend->m_done_count) {
+      pthread_cond_wait(&backend->m_done_cond, &backend->m_lock);
+    }
+    while (backend->m_done_count) {
+      size_t index = backend->m_done[backend->m_done_head];
+      backend->m_done_head =
+          (backend->m_done_head + 1) % t_reader->m_buf_count;
+      backend->m_done_count--;
+      // Completing can request a continued read, which takes the lock
+      pthread_mutex_unlock(&backend->m_lock);
+      _rai_complete(t_reader, index, t_reader->m_bufs[index].m_result);
+      pthread_mutex_lock(&backend->m_lock);
+    }
+    pthread_mutex_unlock(&backend->m_lock);
+    return true;
+  }
+#endif // _RAI_THREADS
+  size_t index = backend->m_requests[backend->m_request_head];
+  backend->m_request_head =
+      (backend->m_request_head + 1) % t_reader->m_buf_count;
+  backend->m_request_count--;
+  struct _rai_buf *buf = &t_reader->m_bufs[index];
+  ssize_t result = pread(buf->m_fd, buf->m_data + buf->m_filled,
+                         buf->m_size - buf->m_filled,
+                         (off_t)(buf->m_offset + buf->m_filled));
+  _rai_complete(t_reader, index, result < 0 ? -errno : (long)result);
+  return true;
+}
+
+/// @internal
+static inline void *_rai_alloc(const char *t_file, int t_line, size_t t_size,
+                               rda_allocator *t_allocator) {
+  void *ptr = t_allocator->alloc(t_allocator->m_ctx, t_size ? t_size : 1);
+  if (!ptr) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  return ptr;
+}
+
+/// @internal
+RAI_INTERNAL_DEF inline void
+_rai_init_with_location(const char *t_file, int t_line,
+                        struct rai_reader *t_reader, size_t t_buf_size,
+                        size_t t_buf_count, rda_allocator *t_allocator) {
+  *t_reader = (struct rai_reader){
+      .m_buf_count = t_buf_count ? t_buf_count : DEFAULT_RAI_BUF_COUNT,
+      .m_buf_size = t_buf_size ? t_buf_size : DEFAULT_RAI_BUF_SIZE,
+      .m_allocator = t_allocator};
+  rda_init(t_reader->m_files, 0, sizeof(struct _rai_file), t_allocator);
+  size_t count = t_reader->m_buf_count;
+  t_reader->m_bufs = (struct _rai_buf *)_rai_alloc(
+      t_file, t_line, count * sizeof(struct _rai_buf), t_allocator);
+  for (size_t i = 0; i < count; i++) {
+    t_reader->m_bufs[i] = (struct _rai_buf){
+        .m_data = (char *)_rai_alloc(t_file, t_line, t_reader->m_buf_size,
+                                     t_allocator)};
+  }
+  struct _rai_backend *backend = (struct _rai_backend *)_rai_alloc(
+      t_file, t_line, sizeof(struct _rai_backend), t_allocator);
+  memset(backend, 0, sizeof(*backend));
+  backend->m_requests =
+      (size_t *)_rai_alloc(t_file, t_line, count * sizeof(size_t), t_allocator);
+  backend->m_done =
+      (size_t *)_rai_alloc(t_file, t_line, count * sizeof(size_t), t_allocator);
+  t_reader->m_backend = backend;
+#ifdef _RAI_URING
+  if (_rai_uring_init(backend, count)) {
+    return;
+  }
+#endif // _RAI_URING
+#ifdef _RAI_THREADS
+  pthread_mutex_init(&backend->m_lock, NULL);
+  pthread_cond_init(&backend->m_request_cond, NULL);
+  pthread_cond_init(&backend->m_done_cond, NULL);
+  if (!pthread_create(&backend->m_thread, NULL, _rai_thread, t_reader)) {
+    backend->m_kind = RAI_BACKEND_THREAD;
+    return;
+  }
+  pthread_cond_destroy(&backend->m_done_cond);
+  pthread_cond_destroy(&backend->m_request_cond);
+  pthread_mutex_destroy(&backend->m_lock);
+#endif // _RAI_THREADS
+  backend->m_kind = RAI_BACKEND_SYNC;
+}
+
+/// @brief Set up a reader with t_buf_count buffers of t_buf_size bytes.
+///
+/// The reads go through io_uring when the kernel allows it, or else through
+/// a background thread calling pread(). The reader holds on to the address
+/// of t_reader, it must not be moved.
+/// @param t_buf_size 0 for DEFAULT_RAI_BUF_SIZE
+/// @param t_buf_count The number of reads in flight plus the blocks held,
+/// 0 for DEFAULT_RAI_BUF_COUNT
+#define rai_init(t_reader, t_buf_size, t_buf_count, t_allocator)               \
+  _rai_init_with_location(__FILE__, __LINE__, (t_reader), (t_buf_size),        \
+                          (t_buf_count), (t_allocator))
+
+/// @internal
+static inline size_t _rai_add_fd(const char *t_file, int t_line,
+                                 struct rai_reader *t_reader, int t_fd,
+                                 bool t_owned) {
+  struct stat st;
+  if (fstat(t_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    fprintf(stderr,
+            "Error: only regular files can be read, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(t_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif // POSIX_FADV_SEQUENTIAL
+  rda_push_back(t_reader->m_files,
+                ((struct _rai_file){.m_fd = t_fd,
+                                    .m_owned = t_owned,
+                                    .m_size = (uint64_t)st.st_size}),
+                t_reader->m_allocator);
+  _rai_fill(t_reader);
+  return rda_size(t_reader->m_files) - 1;
+}
+
+/// @internal
+static inline size_t _rai_open_with_location(const char *t_file, int t_line,
+                                             struct rai_reader *t_reader,
+                                             const char *t_path) {
+  int fd = open(t_path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    fprintf(stderr, "Error: failed to open %s, file: %s, line: %d\n", t_path,
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  return _rai_add_fd(t_file, t_line, t_reader, fd, true);
+}
+
+/// @brief Open a file and start reading it.
+/// @return The index of the file, as in `rai_block.m_file`
+#define rai_open(t_reader, t_path)                                             \
+  _rai_open_with_location(__FILE__, __LINE__, (t_reader), (t_path))
+
+/// @brief Start reading an open regular file, the descriptor is not closed
+/// by the reader.
+/// @return The index of the file, as in `rai_block.m_file`
+#define rai_add_fd(t_reader, t_fd)                                             \
+  _rai_add_fd(__FILE__, __LINE__, (t_reader), (t_fd), false)
+
+/// @internal
+RAI_INTERNAL_DEF inline bool
+_rai_next_with_location(const char *t_file, int t_line,
+                        struct rai_reader *t_reader,
+                        struct rai_block *t_block) {
+  for (;;) {
+    _rai_fill(t_reader);
+#ifdef _RAI_URING
+    if (t_reader->m_backend->m_kind == RAI_BACKEND_URING &&
+        !_rai_uring_enter(t_reader->m_backend, 0)) {
+      break;
+    }
+#endif // _RAI_URING
+    for (size_t i = 0; i < t_reader->m_buf_count; i++) {
+      struct _rai_buf *buf = &t_reader->m_bufs[i];
+      if (buf->m_state != _RAI_BUF_READY) {
+        continue;
+      }
+      struct _rai_file *file = &rda_at(t_reader->m_files, buf->m_file);
+      if (file->m_error) {
+        // The block before it will never come
+        buf->m_state = _RAI_BUF_FREE;
+        continue;
+      }
+      if (buf->m_offset != file->m_delivered) {
+        continue;
+      }
+      buf->m_state = _RAI_BUF_HELD;
+      file->m_delivered += buf->m_size;
+      *t_block = (struct rai_block){
+          .m_data = (rsv){.m_size = buf->m_size, .m_str = buf->m_data},
+          .m_file = buf->m_file,
+          .m_offset = buf->m_offset,
+          .m_buf = i};
+      return true;
+    }
+    if (!t_reader->m_reading) {
+      // Nothing is read and nothing can be, unless blocks are released
+      for (size_t i = 0; i < rda_size(t_reader->m_files); i++) {
+        struct _rai_file *file = &rda_at(t_reader->m_files, i);
+        if (!file->m_error && file->m_delivered < file->m_size) {
+          fprintf(stderr,
+                  "Error: every buffer is held, release blocks before asking "
+                  "for more, file: %s, line: %d\n",
+                  t_file, t_line);
+          exit(EXIT_FAILURE);
+        }
+      }
+      return false;
+    }
+    if (!_rai_wait(t_reader)) {
+      break;
+    }
+  }
+  fprintf(stderr, "Error: io_uring failed, file: %s, line: %d\n", t_file,
+          t_line);
+  exit(EXIT_FAILURE);
+}
+
+/// @brief Wait for the next block of any of the files.
+///
+/// The blocks of a file come in order, the blocks of different files come
+/// in the order their reads finished. All of the blocks are the buffer size,
+/// except the last of each file.
+/// @return false when all the files were read
+#define rai_next(t_reader, t_block)                                            \
+  _rai_next_with_location(__FILE__, __LINE__, (t_reader), (t_block))
+
+/// @brief Give the buffer of a block back, it is read into again right away.
+static inline void rai_release(struct rai_reader *t_reader,
+                               struct rai_block *t_block) {
+  t_reader->m_bufs[t_block->m_buf].m_state = _RAI_BUF_FREE;
+  _rai_fill(t_reader);
+#ifdef _RAI_URING
+  if (t_reader->m_backend->m_kind == RAI_BACKEND_URING) {
+    // An error shows up again in the next rai_next()
+    _rai_uring_enter(t_reader->m_backend, 0);
+  }
+#endif // _RAI_URING
+}
+
+/// @brief Stop reading, close the files opened by the reader and free the
+/// buffers. Blocks still held become invalid.
+RAI_INTERNAL_DEF inline void rai_free(struct rai_reader *t_reader) {
+  rda_allocator *allocator = t_reader->m_allocator;
+  struct _rai_backend *backend = t_reader->m_backend;
+  // Reads in flight write into the buffers, they have to finish first
+  while (t_reader->m_reading && _rai_wait(t_reader)) {
+  }
+#ifdef _RAI_URING
+  if (backend->m_kind == RAI_BACKEND_URING) {
+    _rai_uring_free(backend);
+  }
+#endif // _RAI_URING
+#ifdef _RAI_THREADS
+  if (backend->m_kind == RAI_BACKEND_THREAD) {
+    pthread_mutex_lock(&backend->m_lock);
+    backend->m_stop = true;
+    pthread_cond_signal(&backend->m_request_cond);
+    pthread_mutex_unlock(&backend->m_lock);
+    pthread_join(backend->m_thread, NULL);
+    pthread_cond_destroy(&backend->m_done_cond);
+    pthread_cond_destroy(&backend->m_request_cond);
+    pthread_mutex_destroy(&backend->m_lock);
+  }
+#endif // _RAI_THREADS
+  for (size_t i = 0; i < rda_size(t_reader->m_files); i++) {
+    if (rda_at(t_reader->m_files, i).m_owned) {
+      close(rda_at(t_reader->m_files, i).m_fd);
+    }
+  }
+  rda_free(t_reader->m_files, allocator);
+  for (size_t i = 0; i < t_reader->m_buf_count; i++) {
+    allocator->free(allocator->m_ctx, t_reader->m_bufs[i].m_data);
+  }
+  allocator->free(allocator->m_ctx, t_reader->m_bufs);
+  allocator->free(allocator->m_ctx, backend->m_requests);
+  allocator->free(allocator->m_ctx, backend->m_done);
+  allocator->free(allocator->m_ctx, backend);
+  *t_reader = (struct rai_reader){};
+}
+
+#endif // RIT_AIO_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
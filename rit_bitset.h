@@ -0,0 +1,512 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RBS_INTERNAL_DEF
+#define RBS_INTERNAL_DEF static
+#endif // RBS_INTERNAL_DEF
+
+#ifndef RIT_BITSET_H_INCLUDED
+#define RIT_BITSET_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rit_dyn_arr.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+#define RBS_WORD_BITS 64
+/// @brief Returned by the find functions when no set bit was found
+#define RBS_NPOS ((size_t)-1)
+/// @brief Number of words summarized by a single entry of the rank directory
+#define RBS_RANK_BLOCK_WORDS 8
+
+/// @brief Packed dynamic bitset, 64 bits are stored in every word.
+///
+/// The bits past `m_size` inside the last word are always kept zero, so that
+/// counting and searching can work a whole word at a time.
+struct rbs {
+  size_t m_size;     // Do not modify this, this is private
+  size_t m_capacity; // Do not modify this, this is private
+  uint64_t *m_words; // Do not modify this, this is private
+};
+
+/// @brief Rank directory of a bitset.
+///
+/// Holds the number of set bits before every block of `RBS_RANK_BLOCK_WORDS`
+/// words. It is a snapshot, any modification of the bitset invalidates it.
+struct rbs_rank {
+  size_t m_block_count; // Do not modify this, this is private
+  uint64_t *m_counts;   // Do not modify this, this is private
+};
+
+static inline size_t rbs_size(struct rbs *t_rbs) { return t_rbs->m_size; }
+
+static inline size_t rbs_capacity(struct rbs *t_rbs) {
+  return t_rbs->m_capacity;
+}
+
+/// @brief Number of words needed to hold `t_bits` bits
+static inline size_t rbs_word_count(size_t t_bits) {
+  return (t_bits + RBS_WORD_BITS - 1) / RBS_WORD_BITS;
+}
+
+/// @brief Returns a pointer to the internal words of the bitset.
+static inline uint64_t *rbs_data(struct rbs *t_rbs) { return t_rbs->m_words; }
+
+/// @internal
+static inline size_t _rbs_popcount(uint64_t t_word) {
+#if defined(__GNUC__)
+  return (size_t)__builtin_popcountll(t_word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return (size_t)__popcnt64(t_word);
+#else
+  t_word = t_word - ((t_word >> 1) & 0x5555555555555555ULL);
+  t_word = (t_word & 0x3333333333333333ULL) +
+           ((t_word >> 2) & 0x3333333333333333ULL);
+  t_word = (t_word + (t_word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (size_t)((t_word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/// @internal
+/// @brief Index of the lowest set bit, `t_word` must not be 0
+static inline size_t _rbs_tzcnt(uint64_t t_word) {
+#if defined(__GNUC__)
+  return (size_t)__builtin_ctzll(t_word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, t_word);
+  return (size_t)index;
+#else
+  size_t index = 0;
+  while (!(t_word & 1)) {
+    t_word >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+/// @internal
+/// @brief Position of the `t_rank`th (0-based) set bit inside a word
+static inline size_t _rbs_select_in_word(uint64_t t_word, size_t t_rank) {
+  for (size_t i = 0; i < t_rank; i++) {
+    t_word &= t_word - 1;
+  }
+  return _rbs_tzcnt(t_word);
+}
+
+/// @internal
+/// @brief Clear the unused bits of the last word
+static inline void _rbs_trim(struct rbs *t_rbs) {
+  size_t tail = rbs_size(t_rbs) % RBS_WORD_BITS;
+  if (tail != 0) {
+    t_rbs->m_words[rbs_size(t_rbs) / RBS_WORD_BITS] &= (1ULL << tail) - 1;
+  }
+}
+
+/// @internal
+RBS_INTERNAL_DEF inline void
+_rbs_init_with_location(const char *t_file, int t_line, struct rbs *t_rbs,
+                        size_t t_size, rda_allocator *t_allocator) {
+  size_t capacity = DEFAULT_ARR_CAP * RBS_WORD_BITS;
+  if (capacity < t_size)
+    capacity = t_size;
+  size_t bytes = rbs_word_count(capacity) * sizeof(uint64_t);
+  t_rbs->m_words = (uint64_t *)t_allocator->alloc(t_allocator->m_ctx, bytes);
+  if (!t_rbs->m_words) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  memset(t_rbs->m_words, 0, bytes);
+  t_rbs->m_size = t_size;
+  t_rbs->m_capacity = rbs_word_count(capacity) * RBS_WORD_BITS;
+}
+
+/// @brief Initialize a bitset holding `t_size` bits, all of them reset.
+#define rbs_init(t_rbs, t_size, t_allocator)                                   \
+  _rbs_init_with_location(__FILE__, __LINE__, (t_rbs), (t_size), (t_allocator))
+
+/// @brief Create a bitset.
+#define rbs(t_rbs, t_size, t_allocator)                                        \
+  struct rbs t_rbs = {};                                                       \
+  rbs_init(&t_rbs, (t_size), (t_allocator))
+
+static inline void rbs_free(struct rbs *t_rbs, rda_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, t_rbs->m_words);
+}
+
+/// @internal
+RBS_INTERNAL_DEF inline void _rbs_realloc(const char *t_file, int t_line,
+                                          struct rbs *t_rbs,
+                                          size_t t_new_capacity,
+                                          rda_allocator *t_allocator) {
+  if (t_new_capacity > rbs_capacity(t_rbs)) {
+    size_t old_words = rbs_word_count(rbs_capacity(t_rbs));
+    size_t new_words = rbs_word_count(t_new_capacity);
+    t_rbs->m_words = (uint64_t *)t_allocator->realloc(
+        t_allocator->m_ctx, t_rbs->m_words, old_words * sizeof(uint64_t),
+        new_words * sizeof(uint64_t));
+    if (!t_rbs->m_words) {
+      fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n",
+              t_file, t_line);
+      exit(EXIT_FAILURE);
+    }
+    memset(t_rbs->m_words + old_words, 0,
+           (new_words - old_words) * sizeof(uint64_t));
+    t_rbs->m_capacity = new_words * RBS_WORD_BITS;
+  }
+}
+
+/// @brief Set the capacity of a bitset, in bits.
+#define rbs_reserve(t_rbs, t_new_capacity, t_allocator)                        \
+  _rbs_realloc(__FILE__, __LINE__, (t_rbs), (t_new_capacity), (t_allocator))
+
+/// @internal
+RBS_INTERNAL_DEF
+inline bool _rbs_index_bounds_check(const char *t_file, int t_line,
+                                    struct rbs *t_rbs, size_t t_index) {
+  if (t_index < rbs_size(t_rbs))
+    return true;
+  fprintf(stderr, "Error: bitset index is out of bounds, file: %s, line: %d\n",
+          t_file, t_line);
+  exit(EXIT_FAILURE);
+}
+
+/// @internal
+static inline bool _rbs_test(struct rbs *t_rbs, size_t t_index) {
+  return (t_rbs->m_words[t_index / RBS_WORD_BITS] >>
+          (t_index % RBS_WORD_BITS)) &
+         1;
+}
+/// @internal
+static inline void _rbs_set(struct rbs *t_rbs, size_t t_index) {
+  t_rbs->m_words[t_index / RBS_WORD_BITS] |= 1ULL << (t_index % RBS_WORD_BITS);
+}
+/// @internal
+static inline void _rbs_reset(struct rbs *t_rbs, size_t t_index) {
+  t_rbs->m_words[t_index / RBS_WORD_BITS] &=
+      ~(1ULL << (t_index % RBS_WORD_BITS));
+}
+/// @internal
+static inline void _rbs_flip(struct rbs *t_rbs, size_t t_index) {
+  t_rbs->m_words[t_index / RBS_WORD_BITS] ^= 1ULL << (t_index % RBS_WORD_BITS);
+}
+
+/// @brief Get the value of the bit at t_index.
+#define rbs_test(t_rbs, t_index)                                               \
+  (_rbs_index_bounds_check(__FILE__, __LINE__, (t_rbs), (t_index)),            \
+   _rbs_test((t_rbs), (t_index)))
+/// @brief Set the bit at t_index to 1.
+#define rbs_set(t_rbs, t_index)                                                \
+  (_rbs_index_bounds_check(__FILE__, __LINE__, (t_rbs), (t_index)),            \
+   _rbs_set((t_rbs), (t_index)))
+/// @brief Set the bit at t_index to 0.
+#define rbs_reset(t_rbs, t_index)                                              \
+  (_rbs_index_bounds_check(__FILE__, __LINE__, (t_rbs), (t_index)),            \
+   _rbs_reset((t_rbs), (t_index)))
+/// @brief Toggle the bit at t_index.
+#define rbs_flip(t_rbs, t_index)                                               \
+  (_rbs_index_bounds_check(__FILE__, __LINE__, (t_rbs), (t_index)),            \
+   _rbs_flip((t_rbs), (t_index)))
+
+/// @brief Set every bit to 1.
+static inline void rbs_set_all(struct rbs *t_rbs) {
+  memset(t_rbs->m_words, 0xFF,
+         rbs_word_count(rbs_size(t_rbs)) * sizeof(uint64_t));
+  _rbs_trim(t_rbs);
+}
+
+/// @brief Set every bit to 0.
+static inline void rbs_reset_all(struct rbs *t_rbs) {
+  memset(t_rbs->m_words, 0,
+         rbs_word_count(rbs_size(t_rbs)) * sizeof(uint64_t));
+}
+
+/// @brief Empty out a bitset.
+static inline void rbs_clear(struct rbs *t_rbs) {
+  rbs_reset_all(t_rbs);
+  t_rbs->m_size = 0;
+}
+
+/// @brief Changes the number of bits stored, new bits get the value t_val.
+static inline void rbs_resize(struct rbs *t_rbs, size_t t_size, bool t_val,
+                              rda_allocator *t_allocator) {
+  if (t_size > rbs_capacity(t_rbs)) {
+    size_t capacity = rbs_capacity(t_rbs) * 2;
+    rbs_reserve(t_rbs, capacity < t_size ? t_size : capacity, t_allocator);
+  }
+  size_t old_size = rbs_size(t_rbs);
+  if (t_size < old_size) {
+    // Keep the bits past the size zeroed
+    size_t first_word = rbs_word_count(t_size);
+    memset(t_rbs->m_words + first_word, 0,
+           (rbs_word_count(old_size) - first_word) * sizeof(uint64_t));
+    t_rbs->m_size = t_size;
+    _rbs_trim(t_rbs);
+    return;
+  }
+  t_rbs->m_size = t_size;
+  if (!t_val || t_size == old_size) {
+    return;
+  }
+  size_t index = old_size;
+  for (; index < t_size && index % RBS_WORD_BITS != 0; index++) {
+    _rbs_set(t_rbs, index);
+  }
+  if (index < t_size) {
+    memset(t_rbs->m_words + index / RBS_WORD_BITS, 0xFF,
+           (rbs_word_count(t_size) - index / RBS_WORD_BITS) * sizeof(uint64_t));
+    _rbs_trim(t_rbs);
+  }
+}
+
+static inline void rbs_push_back(struct rbs *t_rbs, bool t_val,
+                                 rda_allocator *t_allocator) {
+  if (rbs_capacity(t_rbs) <= rbs_size(t_rbs)) {
+    rbs_reserve(t_rbs, (rbs_size(t_rbs) + 1) * 2, t_allocator);
+  }
+  if (t_val) {
+    _rbs_set(t_rbs, rbs_size(t_rbs));
+  }
+  t_rbs->m_size++;
+}
+
+static inline void rbs_pop_back(struct rbs *t_rbs) {
+  t_rbs->m_size--;
+  _rbs_reset(t_rbs, rbs_size(t_rbs));
+}
+
+/// @internal
+RBS_INTERNAL_DEF
+inline void _rbs_size_check(const char *t_file, int t_line, struct rbs *t_rbs,
+                            struct rbs *t_rbs_other) {
+  if (rbs_size(t_rbs) == rbs_size(t_rbs_other))
+    return;
+  fprintf(stderr,
+          "Error: bitsets of different sizes cannot be combined, file: %s, "
+          "line: %d\n",
+          t_file, t_line);
+  exit(EXIT_FAILURE);
+}
+
+/// @internal
+#define _rbs_bulk_op(t_rbs, t_rbs_other, t_op)                                 \
+  do {                                                                         \
+    _rbs_size_check(__FILE__, __LINE__, (t_rbs), (t_rbs_other));               \
+    uint64_t *dst = (t_rbs)->m_words;                                          \
+    const uint64_t *src = (t_rbs_other)->m_words;                              \
+    for (size_t i = 0, n = rbs_word_count(rbs_size(t_rbs)); i < n; i++) {      \
+      dst[i] = t_op;                                                           \
+    }                                                                          \
+  } while (0)
+
+/// @brief t_rbs = t_rbs & t_rbs_other, both bitsets must have the same size
+#define rbs_and(t_rbs, t_rbs_other)                                            \
+  _rbs_bulk_op(t_rbs, t_rbs_other, dst[i] & src[i])
+/// @brief t_rbs = t_rbs | t_rbs_other, both bitsets must have the same size
+#define rbs_or(t_rbs, t_rbs_other)                                             \
+  _rbs_bulk_op(t_rbs, t_rbs_other, dst[i] | src[i])
+/// @brief t_rbs = t_rbs ^ t_rbs_other, both bitsets must have the same size
+#define rbs_xor(t_rbs, t_rbs_other)                                            \
+  _rbs_bulk_op(t_rbs, t_rbs_other, dst[i] ^ src[i])
+/// @brief t_rbs = t_rbs & ~t_rbs_other, both bitsets must have the same size
+#define rbs_andnot(t_rbs, t_rbs_other)                                         \
+  _rbs_bulk_op(t_rbs, t_rbs_other, dst[i] & ~src[i])
+
+/// @brief Invert every bit.
+static inline void rbs_flip_all(struct rbs *t_rbs) {
+  for (size_t i = 0, n = rbs_word_count(rbs_size(t_rbs)); i < n; i++) {
+    t_rbs->m_words[i] = ~t_rbs->m_words[i];
+  }
+  _rbs_trim(t_rbs);
+}
+
+/// @brief Number of set bits.
+static inline size_t rbs_count(struct rbs *t_rbs) {
+  size_t count = 0;
+  for (size_t i = 0, n = rbs_word_count(rbs_size(t_rbs)); i < n; i++) {
+    count += _rbs_popcount(t_rbs->m_words[i]);
+  }
+  return count;
+}
+
+/// @brief Check if any bit is set.
+static inline bool rbs_any(struct rbs *t_rbs) {
+  for (size_t i = 0, n = rbs_word_count(rbs_size(t_rbs)); i < n; i++) {
+    if (t_rbs->m_words[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// @brief Index of the first set bit at or after t_index, RBS_NPOS if none.
+static inline size_t rbs_find_next(struct rbs *t_rbs, size_t t_index) {
+  if (t_index >= rbs_size(t_rbs)) {
+    return RBS_NPOS;
+  }
+  size_t word_index = t_index / RBS_WORD_BITS;
+  size_t word_count = rbs_word_count(rbs_size(t_rbs));
+  uint64_t word = t_rbs->m_words[word_index] & (~0ULL
+                                                << (t_index % RBS_WORD_BITS));
+  while (word == 0) {
+    if (++word_index == word_count) {
+      return RBS_NPOS;
+    }
+    word = t_rbs->m_words[word_index];
+  }
+  return word_index * RBS_WORD_BITS + _rbs_tzcnt(word);
+}
+
+/// @brief Index of the first set bit, RBS_NPOS if none.
+static inline size_t rbs_find_first(struct rbs *t_rbs) {
+  return rbs_find_next(t_rbs, 0);
+}
+
+/// @brief Number of set bits in [0, t_index), computed by a linear popcount
+/// scan. Use `struct rbs_rank` for repeated queries.
+static inline size_t rbs_rank(struct rbs *t_rbs, size_t t_index) {
+  if (t_index > rbs_size(t_rbs)) {
+    t_index = rbs_size(t_rbs);
+  }
+  size_t count = 0;
+  size_t full_words = t_index / RBS_WORD_BITS;
+  for (size_t i = 0; i < full_words; i++) {
+    count += _rbs_popcount(t_rbs->m_words[i]);
+  }
+  if (t_index % RBS_WORD_BITS) {
+    count += _rbs_popcount(t_rbs->m_words[full_words] &
+                           ((1ULL << (t_index % RBS_WORD_BITS)) - 1));
+  }
+  return count;
+}
+
+/// @internal
+RBS_INTERNAL_DEF inline void
+_rbs_rank_build_with_location(const char *t_file, int t_line,
+                              struct rbs_rank *t_rank, struct rbs *t_rbs,
+                              rda_allocator *t_allocator) {
+  size_t word_count = rbs_word_count(rbs_size(t_rbs));
+  size_t block_count =
+      (word_count + RBS_RANK_BLOCK_WORDS - 1) / RBS_RANK_BLOCK_WORDS;
+  // One extra entry holding the total count, so select can binary search
+  t_rank->m_counts = (uint64_t *)t_allocator->alloc(
+      t_allocator->m_ctx, (block_count + 1) * sizeof(uint64_t));
+  if (!t_rank->m_counts) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  t_rank->m_block_count = block_count;
+  uint64_t count = 0;
+  for (size_t i = 0; i < word_count; i++) {
+    if (i % RBS_RANK_BLOCK_WORDS == 0) {
+      t_rank->m_counts[i / RBS_RANK_BLOCK_WORDS] = count;
+    }
+    count += _rbs_popcount(t_rbs->m_words[i]);
+  }
+  t_rank->m_counts[block_count] = count;
+}
+
+/// @brief Build the rank directory of a bitset, it takes one 64 bit counter
+/// for every 512 bits of the bitset.
+#define rbs_rank_build(t_rank, t_rbs, t_allocator)                             \
+  _rbs_rank_build_with_location(__FILE__, __LINE__, (t_rank), (t_rbs),         \
+                                (t_allocator))
+
+static inline void rbs_rank_free(struct rbs_rank *t_rank,
+                                 rda_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, t_rank->m_counts);
+}
+
+/// @brief Number of set bits in [0, t_index) using a rank directory.
+static inline size_t rbs_rank_query(struct rbs_rank *t_rank, struct rbs *t_rbs,
+                                    size_t t_index) {
+  if (t_index >= rbs_size(t_rbs)) {
+    return (size_t)t_rank->m_counts[t_rank->m_block_count];
+  }
+  size_t word_index = t_index / RBS_WORD_BITS;
+  size_t block = word_index / RBS_RANK_BLOCK_WORDS;
+  size_t count = (size_t)t_rank->m_counts[block];
+  for (size_t i = block * RBS_RANK_BLOCK_WORDS; i < word_index; i++) {
+    count += _rbs_popcount(t_rbs->m_words[i]);
+  }
+  if (t_index % RBS_WORD_BITS) {
+    count += _rbs_popcount(t_rbs->m_words[word_index] &
+                           ((1ULL << (t_index % RBS_WORD_BITS)) - 1));
+  }
+  return count;
+}
+
+/// @brief Index of the `t_nth` (0-based) set bit using a rank directory,
+/// RBS_NPOS if the bitset has fewer set bits.
+static inline size_t rbs_select(struct rbs_rank *t_rank, struct rbs *t_rbs,
+                                size_t t_nth) {
+  if (t_nth >= t_rank->m_counts[t_rank->m_block_count]) {
+    return RBS_NPOS;
+  }
+  // Find the last block whose count is <= t_nth
+  size_t low = 0, high = t_rank->m_block_count;
+  while (high - low > 1) {
+    size_t mid = low + (high - low) / 2;
+    if (t_rank->m_counts[mid] <= t_nth) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  size_t remaining = t_nth - (size_t)t_rank->m_counts[low];
+  for (size_t i = low * RBS_RANK_BLOCK_WORDS;; i++) {
+    size_t count = _rbs_popcount(t_rbs->m_words[i]);
+    if (remaining < count) {
+      return i * RBS_WORD_BITS +
+             _rbs_select_in_word(t_rbs->m_words[i], remaining);
+    }
+    remaining -= count;
+  }
+}
+
+/// @brief Iterate over the indices of all set bits.
+#define rbs_for_each_set(t_index, t_rbs)                                       \
+  for (size_t t_index = rbs_find_first(t_rbs); t_index != RBS_NPOS;            \
+       t_index = rbs_find_next((t_rbs), t_index + 1))
+
+#endif // RIT_BITSET_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
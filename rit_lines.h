@@ -0,0 +1,529 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RLI_INTERNAL_DEF
+#define RLI_INTERNAL_DEF static
+#endif // RLI_INTERNAL_DEF
+
+#ifndef RIT_LINES_H_INCLUDED
+#define RIT_LINES_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rit_dyn_arr.h"
+#include "rit_serial.h"
+#include "rit_str.h"
+
+// Threads are only used where pthreads are, define RLI_NO_THREADS to never
+// use them
+#if !defined(RLI_NO_THREADS) && !defined(_WIN32)
+#define _RLI_THREADS
+#include <pthread.h>
+#endif
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+// The start of every line is kept as a u32 distance from the start of the
+// first line of its block of 64 lines, those are kept as u64s. That is a bit
+// over 4 bytes per line. If the lines of a block span more than 4 GiB, every
+// start is kept as a u64 instead.
+
+/// @internal
+#define _RLI_BLOCK_SHIFT 6
+/// @internal
+#define _RLI_BLOCK_LINES ((size_t)1 << _RLI_BLOCK_SHIFT)
+
+/// @brief Every thread of `rli_build_parallel()` scans at least this many
+/// bytes
+#ifndef RLI_PARALLEL_MIN
+#define RLI_PARALLEL_MIN ((size_t)1 << 20)
+#endif // RLI_PARALLEL_MIN
+
+#ifndef RLI_MAX_THREADS
+#define RLI_MAX_THREADS 64
+#endif // RLI_MAX_THREADS
+
+/// @brief Index of the lines of a text, the text is not copied and has to
+/// outlive the index.
+///
+/// A line ends at a '\n', which is not part of it. A '\n' at the end of the
+/// text does not start another line.
+struct rli {
+  rsv m_text;          // Do not modify this, this is private
+  size_t m_count;      // Do not modify this, this is private
+  uint64_t *m_samples; // Do not modify this, this is private
+  uint32_t *m_deltas;  // Do not modify this, this is private
+  uint64_t *m_offsets; // Do not modify this, this is private
+};
+
+/// @internal
+/// @brief The part of the text one thread works on
+struct _rli_chunk {
+  struct rli *m_rli;
+  size_t m_begin;
+  size_t m_end;
+  // The number of '\n' in the chunk, then the next line to record
+  size_t m_line;
+  // Lines before this one belong to a block that started in an earlier
+  // chunk, they are recorded from m_begin and fixed up later
+  size_t m_first;
+  bool m_overflow;
+};
+
+/// @brief Get the number of lines.
+static inline size_t rli_count(struct rli *t_rli) { return t_rli->m_count; }
+
+/// @brief Get the text the index is for.
+static inline rsv rli_text(struct rli *t_rli) { return t_rli->m_text; }
+
+/// @internal
+static inline size_t _rli_start(struct rli *t_rli, size_t t_line) {
+  if (t_rli->m_offsets) {
+    return (size_t)t_rli->m_offsets[t_line];
+  }
+  return (size_t)(t_rli->m_samples[t_line >> _RLI_BLOCK_SHIFT] +
+                  t_rli->m_deltas[t_line]);
+}
+
+/// @internal
+/// @brief One past the last character of a line
+static inline size_t _rli_end(struct rli *t_rli, size_t t_line) {
+  if (t_line + 1 < t_rli->m_count) {
+    return _rli_start(t_rli, t_line + 1) - 1;
+  }
+  size_t size = rsv_size(t_rli->m_text);
+  return size - (t_rli->m_text.m_str[size - 1] == '\n');
+}
+
+/// @internal
+static inline void _rli_record(struct _rli_chunk *t_chunk, size_t t_offset) {
+  struct rli *rli = t_chunk->m_rli;
+  size_t line = t_chunk->m_line++;
+  if (rli->m_offsets) {
+    rli->m_offsets[line] = t_offset;
+    return;
+  }
+  size_t block = line >> _RLI_BLOCK_SHIFT;
+  uint64_t base = t_chunk->m_begin;
+  if (block << _RLI_BLOCK_SHIFT >= t_chunk->m_first) {
+    if (!(line & (_RLI_BLOCK_LINES - 1))) {
+      rli->m_samples[block] = t_offset;
+    }
+    base = rli->m_samples[block];
+  }
+  uint64_t delta = t_offset - base;
+  t_chunk->m_overflow |= delta > UINT32_MAX;
+  rli->m_deltas[line] = (uint32_t)delta;
+}
+
+#ifdef _RSV_AVX2
+/// @internal
+__attribute__((target("avx2"))) static inline size_t
+_rli_scan_avx2(struct _rli_chunk *t_chunk, const char *t_str, size_t t_begin,
+               size_t t_end) {
+  __m256i needle = _mm256_set1_epi8('\n');
+  size_t i = t_begin;
+  for (; i + 32 <= t_end; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i *)(t_str + i));
+    uint32_t mask =
+        (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+    while (mask) {
+      _rli_record(t_chunk, i + _rsv_ctz(mask) + 1);
+      mask &= mask - 1;
+    }
+  }
+  return i;
+}
+#endif // _RSV_AVX2
+
+/// @internal
+/// @brief Record the start of the line after every '\n' of a chunk
+static inline void _rli_scan(struct _rli_chunk *t_chunk) {
+  const char *str = t_chunk->m_rli->m_text.m_str;
+  size_t size = rsv_size(t_chunk->m_rli->m_text);
+  // A '\n' at the end of the text has no line after it
+  size_t end = t_chunk->m_end == size ? size - 1 : t_chunk->m_end;
+  size_t i = t_chunk->m_begin;
+#ifdef _RSV_AVX2
+  if (_rsv_has_avx2()) {
+    i = _rli_scan_avx2(t_chunk, str, i, end);
+  }
+#endif // _RSV_AVX2
+#ifdef _RSV_SSE2
+  __m128i needle = _mm_set1_epi8('\n');
+  for (; i + 16 <= end; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+    uint32_t mask =
+        (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+    while (mask) {
+      _rli_record(t_chunk, i + _rsv_ctz(mask) + 1);
+      mask &= mask - 1;
+    }
+  }
+#endif // _RSV_SSE2
+  for (; i < end; i++) {
+    if (str[i] == '\n') {
+      _rli_record(t_chunk, i + 1);
+    }
+  }
+}
+
+/// @internal
+static inline void *_rli_count_chunk(void *t_chunk) {
+  struct _rli_chunk *chunk = (struct _rli_chunk *)t_chunk;
+  rsv text = chunk->m_rli->m_text;
+  chunk->m_line = rsv_count_char(
+      rsv_substr(text, chunk->m_begin, chunk->m_end - chunk->m_begin), '\n');
+  return NULL;
+}
+
+/// @internal
+static inline void *_rli_scan_chunk(void *t_chunk) {
+  _rli_scan((struct _rli_chunk *)t_chunk);
+  return NULL;
+}
+
+/// @internal
+/// @brief Run t_fn on every chunk, the first one on the calling thread
+static inline void _rli_run(struct _rli_chunk *t_chunks, size_t t_count,
+                            void *(*t_fn)(void *)) {
+#ifdef _RLI_THREADS
+  pthread_t threads[RLI_MAX_THREADS];
+  bool started[RLI_MAX_THREADS];
+  for (size_t i = 1; i < t_count; i++) {
+    started[i] = !pthread_create(&threads[i], NULL, t_fn, &t_chunks[i]);
+  }
+  t_fn(&t_chunks[0]);
+  for (size_t i = 1; i < t_count; i++) {
+    if (started[i]) {
+      pthread_join(threads[i], NULL);
+    } else {
+      t_fn(&t_chunks[i]);
+    }
+  }
+#else
+  for (size_t i = 0; i < t_count; i++) {
+    t_fn(&t_chunks[i]);
+  }
+#endif // _RLI_THREADS
+}
+
+/// @internal
+static inline void *_rli_alloc(const char *t_file, int t_line, size_t t_size,
+                               rda_allocator *t_allocator) {
+  void *ptr = t_allocator->alloc(t_allocator->m_ctx, t_size ? t_size : 1);
+  if (!ptr) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  return ptr;
+}
+
+/// @brief Free the memory of the index, not the text.
+static inline void rli_free(struct rli *t_rli, rda_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, t_rli->m_samples);
+  t_allocator->free(t_allocator->m_ctx, t_rli->m_deltas);
+  t_allocator->free(t_allocator->m_ctx, t_rli->m_offsets);
+  *t_rli = (struct rli){};
+}
+
+/// @internal
+RLI_INTERNAL_DEF inline void
+_rli_build_with_location(const char *t_file, int t_line, struct rli *t_rli,
+                         rsv t_text, size_t t_threads,
+                         rda_allocator *t_allocator) {
+  *t_rli = (struct rli){.m_text = t_text};
+  size_t size = rsv_size(t_text);
+  if (size == 0) {
+    return;
+  }
+  size_t count = size / RLI_PARALLEL_MIN;
+  if (count > t_threads) {
+    count = t_threads;
+  }
+  if (count > RLI_MAX_THREADS) {
+    count = RLI_MAX_THREADS;
+  }
+  if (count == 0) {
+    count = 1;
+  }
+  struct _rli_chunk chunks[RLI_MAX_THREADS];
+  for (size_t i = 0; i < count; i++) {
+    chunks[i] = (struct _rli_chunk){.m_rli = t_rli,
+                                    .m_begin = size / count * i,
+                                    .m_end = i + 1 < count
+                                                 ? size / count * (i + 1)
+                                                 : size};
+  }
+  // Counting first gives every chunk the index of its first line, and the
+  // arrays their exact size
+  _rli_run(chunks, count, _rli_count_chunk);
+  size_t line = 1;
+  for (size_t i = 0; i < count; i++) {
+    size_t newlines = chunks[i].m_line;
+    chunks[i].m_line = chunks[i].m_first = line;
+    line += newlines;
+  }
+  t_rli->m_count = line - (t_text.m_str[size - 1] == '\n');
+  t_rli->m_samples = (uint64_t *)_rli_alloc(
+      t_file, t_line,
+      ((t_rli->m_count >> _RLI_BLOCK_SHIFT) + 1) * sizeof(uint64_t),
+      t_allocator);
+  t_rli->m_deltas = (uint32_t *)_rli_alloc(
+      t_file, t_line, t_rli->m_count * sizeof(uint32_t), t_allocator);
+  t_rli->m_samples[0] = 0;
+  t_rli->m_deltas[0] = 0;
+  _rli_run(chunks, count, _rli_scan_chunk);
+  // The lines of a block that started in an earlier chunk were recorded
+  // from the start of their chunk
+  bool overflow = false;
+  for (size_t i = 0; i < count; i++) {
+    overflow |= chunks[i].m_overflow;
+    size_t first = chunks[i].m_first;
+    if (!(first & (_RLI_BLOCK_LINES - 1))) {
+      continue;
+    }
+    size_t block = first >> _RLI_BLOCK_SHIFT;
+    size_t end = (block + 1) << _RLI_BLOCK_SHIFT;
+    if (end > chunks[i].m_line) {
+      end = chunks[i].m_line;
+    }
+    for (size_t j = first; j < end; j++) {
+      uint64_t delta = (uint64_t)t_rli->m_deltas[j] + chunks[i].m_begin -
+                       t_rli->m_samples[block];
+      overflow |= delta > UINT32_MAX;
+      t_rli->m_deltas[j] = (uint32_t)delta;
+    }
+  }
+  if (overflow) {
+    t_allocator->free(t_allocator->m_ctx, t_rli->m_samples);
+    t_allocator->free(t_allocator->m_ctx, t_rli->m_deltas);
+    t_rli->m_samples = NULL;
+    t_rli->m_deltas = NULL;
+    t_rli->m_offsets = (uint64_t *)_rli_alloc(
+        t_file, t_line, t_rli->m_count * sizeof(uint64_t), t_allocator);
+    t_rli->m_offsets[0] = 0;
+    struct _rli_chunk chunk = {
+        .m_rli = t_rli, .m_end = size, .m_line = 1, .m_first = 1};
+    _rli_scan(&chunk);
+  }
+}
+
+/// @brief Build the index of the lines of t_text.
+///
+/// The '\n' are found 32 or 16 bytes at a time with AVX2 or SSE2.
+#define rli_build(t_rli, t_text, t_allocator)                                  \
+  _rli_build_with_location(__FILE__, __LINE__, (t_rli), (t_text), 1,           \
+                           (t_allocator))
+
+/// @brief Same as `rli_build()`, with the text split between up to t_threads
+/// threads that scan at least RLI_PARALLEL_MIN bytes each.
+///
+/// Without pthreads, or with RLI_NO_THREADS defined, the chunks are scanned
+/// one after the other.
+#define rli_build_parallel(t_rli, t_text, t_threads, t_allocator)              \
+  _rli_build_with_location(__FILE__, __LINE__, (t_rli), (t_text),              \
+                           (t_threads), (t_allocator))
+
+/// @internal
+RLI_INTERNAL_DEF inline bool _rli_line_bounds_check(const char *t_file,
+                                                    int t_line,
+                                                    struct rli *t_rli,
+                                                    size_t t_index) {
+  if (t_index < rli_count(t_rli))
+    return true;
+  fprintf(stderr, "Error: line index is out of bounds, file: %s, line: %d\n",
+          t_file, t_line);
+  exit(EXIT_FAILURE);
+}
+
+/// @internal
+static inline size_t _rli_line_offset(struct rli *t_rli, size_t t_index) {
+  return _rli_start(t_rli, t_index);
+}
+
+/// @internal
+static inline rsv _rli_line(struct rli *t_rli, size_t t_index) {
+  size_t start = _rli_start(t_rli, t_index);
+  return rsv_substr(t_rli->m_text, start, _rli_end(t_rli, t_index) - start);
+}
+
+/// @brief Get the offset of the first character of the line at t_index.
+#define rli_line_offset(t_rli, t_index)                                        \
+  (_rli_line_bounds_check(__FILE__, __LINE__, (t_rli), (t_index)),             \
+   _rli_line_offset((t_rli), (t_index)))
+
+/// @brief Get the line at t_index without its '\n', in constant time.
+#define rli_line(t_rli, t_index)                                               \
+  (_rli_line_bounds_check(__FILE__, __LINE__, (t_rli), (t_index)),             \
+   _rli_line((t_rli), (t_index)))
+
+/// @internal
+RLI_INTERNAL_DEF inline size_t _rli_find(struct rli *t_rli, size_t t_offset) {
+  // The last line that starts at or before t_offset, first the block and
+  // then the line inside of it
+  size_t low = 0, high = t_rli->m_count;
+  if (!t_rli->m_offsets) {
+    size_t blocks = ((t_rli->m_count - 1) >> _RLI_BLOCK_SHIFT) + 1;
+    size_t block_low = 0, block_high = blocks;
+    while (block_high - block_low > 1) {
+      size_t mid = block_low + (block_high - block_low) / 2;
+      if (t_rli->m_samples[mid] <= t_offset) {
+        block_low = mid;
+      } else {
+        block_high = mid;
+      }
+    }
+    low = block_low << _RLI_BLOCK_SHIFT;
+    if (block_high << _RLI_BLOCK_SHIFT < high) {
+      high = block_high << _RLI_BLOCK_SHIFT;
+    }
+  }
+  while (high - low > 1) {
+    size_t mid = low + (high - low) / 2;
+    if (_rli_start(t_rli, mid) <= t_offset) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/// @internal
+RLI_INTERNAL_DEF inline bool _rli_offset_bounds_check(const char *t_file,
+                                                      int t_line,
+                                                      struct rli *t_rli,
+                                                      size_t t_offset) {
+  if (t_offset < rsv_size(t_rli->m_text))
+    return true;
+  fprintf(stderr, "Error: text offset is out of bounds, file: %s, line: %d\n",
+          t_file, t_line);
+  exit(EXIT_FAILURE);
+}
+
+/// @brief Get the index of the line the character at t_offset is part of, a
+/// '\n' is part of the line it ends.
+///
+/// Binary search on the blocks of 64 lines, then inside of the block.
+#define rli_find(t_rli, t_offset)                                              \
+  (_rli_offset_bounds_check(__FILE__, __LINE__, (t_rli), (t_offset)),          \
+   _rli_find((t_rli), (t_offset)))
+
+/// @brief Write the index as rit_serial records, the text is not written.
+///
+/// The size and the hash of the text are written with it, to recognize the
+/// text when the index is read back.
+static inline void rli_write(struct rsr_writer *t_writer, struct rli *t_rli) {
+  uint64_t header[4] = {rsv_size(t_rli->m_text), rsv_hash(t_rli->m_text),
+                        t_rli->m_count, t_rli->m_offsets != NULL};
+  rsr_write_array(t_writer, header, sizeof(uint64_t), 4);
+  if (t_rli->m_offsets) {
+    rsr_write_array(t_writer, t_rli->m_offsets, sizeof(uint64_t),
+                    t_rli->m_count);
+    return;
+  }
+  size_t blocks =
+      t_rli->m_count ? ((t_rli->m_count - 1) >> _RLI_BLOCK_SHIFT) + 1 : 0;
+  rsr_write_array(t_writer, t_rli->m_samples, sizeof(uint64_t), blocks);
+  rsr_write_array(t_writer, t_rli->m_deltas, sizeof(uint32_t),
+                  t_rli->m_count);
+}
+
+/// @brief Read an index written by `rli_write()` for the same t_text.
+///
+/// The size and the hash of t_text have to match the ones the index was
+/// written with, so reading the index of another text fails instead of giving
+/// wrong lines. Hashing reads every byte, but a lot faster than `rli_build()`
+/// scans them. Every line start is also checked against t_text, to catch a
+/// damaged index.
+/// @return false on error, t_rli is then empty
+RLI_INTERNAL_DEF inline bool rli_read(struct rsr_reader *t_reader,
+                                      struct rli *t_rli, rsv t_text,
+                                      rda_allocator *t_allocator) {
+  *t_rli = (struct rli){.m_text = t_text};
+  size_t size = 0;
+  uint64_t *header =
+      (uint64_t *)rsr_read_array(t_reader, sizeof(uint64_t), &size,
+                                 t_allocator);
+  if (!header) {
+    return false;
+  }
+  bool valid = size == 4 && header[0] == rsv_size(t_text) &&
+               header[1] == rsv_hash(t_text);
+  t_rli->m_count = valid ? (size_t)header[2] : 0;
+  bool wide = valid && header[3];
+  t_allocator->free(t_allocator->m_ctx, header);
+  if (!valid) {
+    return false;
+  }
+  size_t blocks =
+      t_rli->m_count ? ((t_rli->m_count - 1) >> _RLI_BLOCK_SHIFT) + 1 : 0;
+  if (wide) {
+    t_rli->m_offsets = (uint64_t *)rsr_read_array(t_reader, sizeof(uint64_t),
+                                                  &size, t_allocator);
+    valid = t_rli->m_offsets && size == t_rli->m_count;
+  } else {
+    t_rli->m_samples = (uint64_t *)rsr_read_array(t_reader, sizeof(uint64_t),
+                                                  &size, t_allocator);
+    valid = t_rli->m_samples && size == blocks;
+    t_rli->m_deltas = (uint32_t *)rsr_read_array(t_reader, sizeof(uint32_t),
+                                                 &size, t_allocator);
+    valid = valid && t_rli->m_deltas && size == t_rli->m_count;
+  }
+  // A text has at least one line, the lines start after a '\n' and in order,
+  // and a block starts at its first line
+  valid = valid && (rsv_size(t_text) == 0) == (t_rli->m_count == 0);
+  for (size_t i = 0; valid && i < t_rli->m_count; i++) {
+    uint64_t start =
+        wide ? t_rli->m_offsets[i]
+             : t_rli->m_samples[i >> _RLI_BLOCK_SHIFT] + t_rli->m_deltas[i];
+    valid = i == 0 ? start == 0
+                   : start < rsv_size(t_text) &&
+                         start > _rli_start(t_rli, i - 1) &&
+                         t_text.m_str[start - 1] == '\n';
+    valid = valid && (wide || (i & (_RLI_BLOCK_LINES - 1)) ||
+                      t_rli->m_deltas[i] == 0);
+  }
+  if (!valid) {
+    rli_free(t_rli, t_allocator);
+    t_rli->m_text = t_text;
+    return false;
+  }
+  return true;
+}
+
+#endif // RIT_LINES_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
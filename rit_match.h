@@ -0,0 +1,566 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RMT_INTERNAL_DEF
+#define RMT_INTERNAL_DEF static
+#endif // RMT_INTERNAL_DEF
+
+#ifndef RIT_MATCH_H_INCLUDED
+#define RIT_MATCH_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena_allocator.h"
+#include "rit_str.h"
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/// @brief Pattern sets up to this size are searched with the Teddy prefilter
+/// when the cpu has SSSE3, bigger ones only use the automaton
+#ifndef RMT_TEDDY_MAX
+#define RMT_TEDDY_MAX 32
+#endif // RMT_TEDDY_MAX
+
+/// @internal
+#define _RMT_NONE UINT32_MAX
+/// @internal
+#define _RMT_BUCKETS 8
+/// @internal
+/// @brief At most this many bytes from the end of every pattern are
+/// fingerprinted
+#define _RMT_FINGERPRINT 3
+
+// Teddy needs a byte shuffle, which first came with SSSE3, so it is compiled
+// with target attributes and only used after checking the cpu at run time.
+#ifdef _RSV_AVX2
+#define _RMT_TEDDY
+#endif // _RSV_AVX2
+
+/// @brief A match reported by rmt_next()
+struct rmt_match {
+  size_t m_pattern; // Index of the pattern in the array it was built from
+  size_t m_offset;  // Index of the first character of the match in the text
+};
+
+/// @brief A set of patterns compiled for searching all of them in one pass.
+///
+/// The patterns are compiled into an Aho-Corasick automaton with a full
+/// transition table, one lookup per character of the text. Bytes that no
+/// pattern uses share one column of the table. Small sets also get Teddy
+/// tables, which find the places where a pattern may end 16 or 32 bytes at a
+/// time, and only those places are compared to the patterns.
+///
+/// Everything is allocated in an arena, which owns it.
+struct rmt {
+  rsv *m_patterns;                       // Do not modify this, this is private
+  uint32_t m_pattern_count;              // Do not modify this, this is private
+  uint32_t m_class_count;                // Do not modify this, this is private
+  uint16_t m_classes[256];               // Do not modify this, this is private
+  uint32_t *m_next;                      // Do not modify this, this is private
+  uint32_t *m_first;                     // Do not modify this, this is private
+  uint32_t *m_dict;                      // Do not modify this, this is private
+  uint32_t *m_same;                      // Do not modify this, this is private
+  bool m_teddy;                          // Do not modify this, this is private
+  uint32_t m_fingerprint;                // Do not modify this, this is private
+  uint32_t *m_order;                     // Do not modify this, this is private
+  uint32_t m_buckets[_RMT_BUCKETS + 1];  // Do not modify this, this is private
+  uint8_t m_masks[_RMT_FINGERPRINT][32]; // Do not modify this, this is private
+};
+
+/// @brief Iterator over the matches of a rmt in a text
+struct rmt_iter {
+  const struct rmt *m_matcher; // Do not modify this, this is private
+  rsv m_text;                  // Do not modify this, this is private
+  size_t m_pos;                // Do not modify this, this is private
+  bool m_teddy;                // Do not modify this, this is private
+  uint32_t m_state;            // Do not modify this, this is private
+  uint32_t m_report;           // Do not modify this, this is private
+  uint32_t m_pattern;          // Do not modify this, this is private
+  size_t m_end;                // Do not modify this, this is private
+  size_t m_block;              // Do not modify this, this is private
+  uint32_t m_mask;             // Do not modify this, this is private
+  uint32_t m_bucket_set;       // Do not modify this, this is private
+  uint32_t m_index;            // Do not modify this, this is private
+};
+
+/// @brief Number of patterns in a rmt
+static inline size_t rmt_pattern_count(const struct rmt *t_matcher) {
+  return t_matcher->m_pattern_count;
+}
+
+/// @brief Get a pattern by the index it was built with, the text is the copy
+/// kept in the arena
+static inline rsv rmt_pattern(const struct rmt *t_matcher, size_t t_pattern) {
+  return t_matcher->m_patterns[t_pattern];
+}
+
+/// @internal
+static inline void *_rmt_malloc(const char *t_file, int t_line,
+                                size_t t_size) {
+  void *ptr = malloc(t_size ? t_size : 1);
+  if (ptr == NULL) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  return ptr;
+}
+
+/// @internal
+/// @brief Fill the Teddy tables. The patterns are put in order of decreasing
+/// size and cut into 8 buckets, so walking the buckets in order checks the
+/// longest patterns first, like the automaton reports them.
+static inline void _rmt_build_teddy(struct rmt *t_matcher, Arena *t_arena) {
+  uint32_t count = t_matcher->m_pattern_count;
+  uint32_t *order = arena_alloc_arr(t_arena, uint32_t, count);
+  size_t min_size = SIZE_MAX;
+  for (uint32_t i = 0; i < count; i++) {
+    size_t size = rsv_size(t_matcher->m_patterns[i]);
+    uint32_t j = i;
+    for (; j > 0 && rsv_size(t_matcher->m_patterns[order[j - 1]]) < size; j--) {
+      order[j] = order[j - 1];
+    }
+    order[j] = i;
+    if (size < min_size) {
+      min_size = size;
+    }
+  }
+  t_matcher->m_order = order;
+  t_matcher->m_fingerprint =
+      min_size < _RMT_FINGERPRINT ? (uint32_t)min_size : _RMT_FINGERPRINT;
+  memset(t_matcher->m_masks, 0, sizeof(t_matcher->m_masks));
+  for (uint32_t bucket = 0; bucket <= _RMT_BUCKETS; bucket++) {
+    t_matcher->m_buckets[bucket] = bucket * count / _RMT_BUCKETS;
+  }
+  for (uint32_t bucket = 0; bucket < _RMT_BUCKETS; bucket++) {
+    for (uint32_t i = t_matcher->m_buckets[bucket];
+         i < t_matcher->m_buckets[bucket + 1]; i++) {
+      rsv pattern = t_matcher->m_patterns[order[i]];
+      for (uint32_t j = 0; j < t_matcher->m_fingerprint; j++) {
+        size_t index = rsv_size(pattern) - 1 - j;
+        unsigned char ch = (unsigned char)pattern.m_str[index];
+        t_matcher->m_masks[j][ch & 15] |= (uint8_t)(1u << bucket);
+        t_matcher->m_masks[j][16 + (ch >> 4)] |= (uint8_t)(1u << bucket);
+      }
+    }
+  }
+  t_matcher->m_teddy = true;
+}
+
+/// @internal
+RMT_INTERNAL_DEF inline struct rmt
+_rmt_build_with_location(const char *t_file, int t_line, Arena *t_arena,
+                         const rsv *t_patterns, size_t t_count) {
+  if (t_count >= _RMT_NONE) {
+    fprintf(stderr, "Error: too many patterns, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  struct rmt matcher = {.m_pattern_count = (uint32_t)t_count};
+  // Copy the patterns, so the caller's strings may go away
+  size_t total = 0;
+  bool used[256] = {false};
+  for (size_t i = 0; i < t_count; i++) {
+    if (rsv_size(t_patterns[i]) == 0) {
+      fprintf(stderr, "Error: pattern %zu is empty, file: %s, line: %d\n", i,
+              t_file, t_line);
+      exit(EXIT_FAILURE);
+    }
+    total += rsv_size(t_patterns[i]);
+  }
+  if (total >= _RMT_NONE / 257) {
+    fprintf(stderr, "Error: patterns are too long, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  matcher.m_patterns = arena_alloc_arr(t_arena, rsv, t_count);
+  char *text = arena_alloc(t_arena, total);
+  for (size_t i = 0; i < t_count; i++) {
+    memcpy(text, t_patterns[i].m_str, rsv_size(t_patterns[i]));
+    matcher.m_patterns[i] =
+        (rsv){.m_size = rsv_size(t_patterns[i]), .m_str = text};
+    for (size_t j = 0; j < rsv_size(t_patterns[i]); j++) {
+      used[(unsigned char)text[j]] = true;
+    }
+    text += rsv_size(t_patterns[i]);
+  }
+
+  // Class 0 is every byte that is in no pattern
+  uint32_t class_count = 1;
+  for (size_t ch = 0; ch < 256; ch++) {
+    matcher.m_classes[ch] = used[ch] ? (uint16_t)class_count++ : 0;
+  }
+  matcher.m_class_count = class_count;
+  // A row has a column for each class and one more for the first state to
+  // report, a state is the index of its row times the row size
+  size_t stride = class_count + 1;
+  size_t max_states = total + 1;
+  uint32_t *next = arena_alloc_arr(t_arena, uint32_t, max_states * stride);
+  memset(next, 0, max_states * stride * sizeof(uint32_t));
+  matcher.m_first = arena_alloc_arr(t_arena, uint32_t, max_states);
+  matcher.m_dict = arena_alloc_arr(t_arena, uint32_t, max_states);
+  matcher.m_same = arena_alloc_arr(t_arena, uint32_t, t_count);
+  for (size_t i = 0; i < max_states; i++) {
+    matcher.m_first[i] = _RMT_NONE;
+  }
+
+  // The trie, 0 is the root and no edge ever goes back to it. The patterns
+  // are inserted backwards, so equal patterns end up in increasing order.
+  uint32_t state_count = 1;
+  for (size_t i = t_count; i-- > 0;) {
+    rsv pattern = matcher.m_patterns[i];
+    uint32_t state = 0;
+    for (size_t j = 0; j < rsv_size(pattern); j++) {
+      unsigned char ch = (unsigned char)pattern.m_str[j];
+      uint32_t *edge = &next[state * stride + matcher.m_classes[ch]];
+      if (*edge == 0) {
+        *edge = state_count++;
+      }
+      state = *edge;
+    }
+    matcher.m_same[i] = matcher.m_first[state];
+    matcher.m_first[state] = (uint32_t)i;
+  }
+
+  // Breadth first, every state's failure state is done before the state.
+  // Missing edges are copied from the failure state, which turns the trie
+  // into a full transition table.
+  uint32_t *fail = _rmt_malloc(t_file, t_line, state_count * sizeof(uint32_t));
+  uint32_t *queue =
+      _rmt_malloc(t_file, t_line, state_count * sizeof(uint32_t));
+  size_t queue_begin = 0, queue_end = 0;
+  fail[0] = 0;
+  queue[queue_end++] = 0;
+  while (queue_begin < queue_end) {
+    uint32_t state = queue[queue_begin++];
+    uint32_t *row = &next[state * stride];
+    uint32_t *fail_row = &next[fail[state] * stride];
+    for (size_t ch = 0; ch < class_count; ch++) {
+      if (row[ch] != 0) {
+        fail[row[ch]] = state == 0 ? 0 : fail_row[ch];
+        queue[queue_end++] = row[ch];
+      } else {
+        row[ch] = fail_row[ch];
+      }
+    }
+    // The first state on the failure chain that ends a pattern. The root
+    // ends no pattern, so 0 means none here.
+    uint32_t dict = state == 0 ? 0 : next[fail[state] * stride + class_count];
+    matcher.m_dict[state] = dict == 0 ? _RMT_NONE : dict;
+    row[class_count] = matcher.m_first[state] != _RMT_NONE
+                           ? (uint32_t)(state * stride)
+                           : dict;
+  }
+  // Store the states as row offsets, which saves a multiplication per
+  // character
+  for (size_t state = 0; state < state_count; state++) {
+    uint32_t *row = &next[state * stride];
+    for (size_t ch = 0; ch < class_count; ch++) {
+      row[ch] *= (uint32_t)stride;
+    }
+    if (row[class_count] == 0 && state != 0) {
+      row[class_count] = _RMT_NONE;
+    }
+  }
+  next[class_count] = _RMT_NONE;
+  free(queue);
+  free(fail);
+  matcher.m_next = next;
+
+  if (t_count > 0 && t_count <= RMT_TEDDY_MAX) {
+    _rmt_build_teddy(&matcher, t_arena);
+  }
+  return matcher;
+}
+
+/// @brief Compile the patterns in a rda of rsv into a rmt.
+///
+/// The patterns are copied into the arena, the rda can be freed afterwards.
+/// Patterns can't be empty. The automaton has at most one state per
+/// character of the patterns.
+#define rmt_build(t_arena, t_patterns)                                         \
+  _rmt_build_with_location(__FILE__, __LINE__, (t_arena), (t_patterns).m_data, \
+                           rda_size(t_patterns))
+
+/// @brief Same as `rmt_build()`, from a plain array of rsv.
+#define rmt_build_arr(t_arena, t_patterns, t_count)                            \
+  _rmt_build_with_location(__FILE__, __LINE__, (t_arena), (t_patterns),        \
+                           (t_count))
+
+/// @internal
+/// @brief The buckets that may have a pattern ending at t_end
+static inline uint32_t _rmt_teddy_buckets(const struct rmt *t_matcher,
+                                          const char *t_str, size_t t_end) {
+  uint32_t buckets = 0xff;
+  for (uint32_t j = 0; j < t_matcher->m_fingerprint; j++) {
+    unsigned char ch = (unsigned char)t_str[t_end - j];
+    buckets &= (uint32_t)t_matcher->m_masks[j][ch & 15] &
+               t_matcher->m_masks[j][16 + (ch >> 4)];
+  }
+  return buckets;
+}
+
+#ifdef _RMT_TEDDY
+/// @internal
+static inline bool _rmt_has_ssse3(void) {
+  // Threads may race to fill it in, they all store the same value
+  static int has_ssse3 = -1;
+  int cached = __atomic_load_n(&has_ssse3, __ATOMIC_RELAXED);
+  if (cached < 0) {
+    cached = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    __atomic_store_n(&has_ssse3, cached, __ATOMIC_RELAXED);
+  }
+  return cached;
+}
+
+/// @internal
+/// @brief Find the first 16 possible pattern ends starting at t_pos that have
+/// at least one candidate.
+///
+/// Every fingerprinted byte looks its low and high half up in a table of
+/// buckets, a bucket stays a candidate if all of its lookups have its bit.
+/// @return The start of the block, t_mask has a bit for every candidate in it
+__attribute__((target("ssse3"))) static inline size_t
+_rmt_teddy_ssse3(const struct rmt *t_matcher, const char *t_str, size_t t_size,
+                 size_t t_pos, uint32_t *t_mask) {
+  __m128i masks[_RMT_FINGERPRINT][2];
+  for (uint32_t j = 0; j < t_matcher->m_fingerprint; j++) {
+    masks[j][0] = _mm_loadu_si128((const __m128i *)t_matcher->m_masks[j]);
+    masks[j][1] =
+        _mm_loadu_si128((const __m128i *)(t_matcher->m_masks[j] + 16));
+  }
+  __m128i low_nibble = _mm_set1_epi8(0x0f);
+  for (; t_pos + 16 <= t_size; t_pos += 16) {
+    __m128i buckets = _mm_set1_epi8((char)0xff);
+    for (uint32_t j = 0; j < t_matcher->m_fingerprint; j++) {
+      __m128i block = _mm_loadu_si128((const __m128i *)(t_str + t_pos - j));
+      __m128i low = _mm_and_si128(block, low_nibble);
+      __m128i high = _mm_and_si128(_mm_srli_epi16(block, 4), low_nibble);
+      buckets = _mm_and_si128(
+          buckets, _mm_and_si128(_mm_shuffle_epi8(masks[j][0], low),
+                                 _mm_shuffle_epi8(masks[j][1], high)));
+    }
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(
+                        _mm_cmpeq_epi8(buckets, _mm_setzero_si128())) ^
+                    0xffff;
+    if (mask) {
+      *t_mask = mask;
+      return t_pos;
+    }
+  }
+  *t_mask = 0;
+  return t_pos;
+}
+
+/// @internal
+/// @brief Same as _rmt_teddy_ssse3(), 32 possible pattern ends at a time
+__attribute__((target("avx2"))) static inline size_t
+_rmt_teddy_avx2(const struct rmt *t_matcher, const char *t_str, size_t t_size,
+                size_t t_pos, uint32_t *t_mask) {
+  __m256i masks[_RMT_FINGERPRINT][2];
+  for (uint32_t j = 0; j < t_matcher->m_fingerprint; j++) {
+    masks[j][0] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *)t_matcher->m_masks[j]));
+    masks[j][1] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *)(t_matcher->m_masks[j] + 16)));
+  }
+  __m256i low_nibble = _mm256_set1_epi8(0x0f);
+  for (; t_pos + 32 <= t_size; t_pos += 32) {
+    __m256i buckets = _mm256_set1_epi8((char)0xff);
+    for (uint32_t j = 0; j < t_matcher->m_fingerprint; j++) {
+      __m256i block =
+          _mm256_loadu_si256((const __m256i *)(t_str + t_pos - j));
+      __m256i low = _mm256_and_si256(block, low_nibble);
+      __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibble);
+      buckets = _mm256_and_si256(
+          buckets, _mm256_and_si256(_mm256_shuffle_epi8(masks[j][0], low),
+                                    _mm256_shuffle_epi8(masks[j][1], high)));
+    }
+    uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(buckets, _mm256_setzero_si256()));
+    if (mask) {
+      *t_mask = mask;
+      return t_pos;
+    }
+  }
+  *t_mask = 0;
+  return t_pos;
+}
+#endif // _RMT_TEDDY
+
+/// @brief Start searching a text for the patterns of a rmt.
+///
+/// The rmt and the text have to outlive the iterator.
+static inline struct rmt_iter rmt_iter(const struct rmt *t_matcher,
+                                       rsv t_text) {
+  struct rmt_iter iter = {.m_matcher = t_matcher,
+                          .m_text = t_text,
+                          .m_report = _RMT_NONE,
+                          .m_pattern = _RMT_NONE};
+#ifdef _RMT_TEDDY
+  iter.m_teddy = t_matcher->m_teddy && _rmt_has_ssse3();
+#endif // _RMT_TEDDY
+  if (iter.m_teddy) {
+    // No pattern can end before the fingerprint
+    iter.m_pos = t_matcher->m_fingerprint - 1;
+  }
+  return iter;
+}
+
+/// @internal
+/// @brief Find the next block of possible pattern ends.
+/// @return false at the end of the text
+static inline bool _rmt_teddy_scan(struct rmt_iter *t_iter) {
+  const struct rmt *matcher = t_iter->m_matcher;
+  const char *str = t_iter->m_text.m_str;
+  size_t size = rsv_size(t_iter->m_text);
+  size_t pos = t_iter->m_pos;
+#ifdef _RMT_TEDDY
+  uint32_t mask = 0;
+  if (_rsv_has_avx2()) {
+    pos = _rmt_teddy_avx2(matcher, str, size, pos, &mask);
+    if (mask) {
+      t_iter->m_block = pos;
+      t_iter->m_mask = mask;
+      t_iter->m_pos = pos + 32;
+      return true;
+    }
+  }
+  pos = _rmt_teddy_ssse3(matcher, str, size, pos, &mask);
+  if (mask) {
+    t_iter->m_block = pos;
+    t_iter->m_mask = mask;
+    t_iter->m_pos = pos + 16;
+    return true;
+  }
+#endif // _RMT_TEDDY
+  for (; pos < size; pos++) {
+    if (_rmt_teddy_buckets(matcher, str, pos)) {
+      t_iter->m_block = pos;
+      t_iter->m_mask = 1;
+      t_iter->m_pos = pos + 1;
+      return true;
+    }
+  }
+  t_iter->m_pos = pos;
+  return false;
+}
+
+/// @internal
+static inline bool _rmt_next_teddy(struct rmt_iter *t_iter,
+                                   struct rmt_match *t_match) {
+  const struct rmt *matcher = t_iter->m_matcher;
+  const char *str = t_iter->m_text.m_str;
+  for (;;) {
+    // Compare the patterns of the buckets left at the current end
+    while (t_iter->m_bucket_set) {
+      uint32_t bucket = _rsv_ctz(t_iter->m_bucket_set);
+      while (t_iter->m_index < matcher->m_buckets[bucket + 1]) {
+        uint32_t pattern = matcher->m_order[t_iter->m_index++];
+        size_t size = rsv_size(matcher->m_patterns[pattern]);
+        if (size <= t_iter->m_end + 1 &&
+            memcmp(str + t_iter->m_end + 1 - size,
+                   matcher->m_patterns[pattern].m_str, size) == 0) {
+          t_match->m_pattern = pattern;
+          t_match->m_offset = t_iter->m_end + 1 - size;
+          return true;
+        }
+      }
+      t_iter->m_bucket_set &= t_iter->m_bucket_set - 1;
+      if (t_iter->m_bucket_set) {
+        t_iter->m_index =
+            matcher->m_buckets[_rsv_ctz(t_iter->m_bucket_set)];
+      }
+    }
+    if (t_iter->m_mask == 0 && !_rmt_teddy_scan(t_iter)) {
+      return false;
+    }
+    t_iter->m_end = t_iter->m_block + _rsv_ctz(t_iter->m_mask);
+    t_iter->m_mask &= t_iter->m_mask - 1;
+    t_iter->m_bucket_set = _rmt_teddy_buckets(matcher, str, t_iter->m_end);
+    t_iter->m_index = matcher->m_buckets[_rsv_ctz(t_iter->m_bucket_set)];
+  }
+}
+
+/// @brief Get the next match.
+///
+/// Matches may overlap. They come in order of where they end, matches that
+/// end at the same place come longest first, then by pattern index.
+/// @return false when there are no more matches
+static inline bool rmt_next(struct rmt_iter *t_iter,
+                            struct rmt_match *t_match) {
+  if (t_iter->m_teddy) {
+    return _rmt_next_teddy(t_iter, t_match);
+  }
+  const struct rmt *matcher = t_iter->m_matcher;
+  const uint32_t *next = matcher->m_next;
+  const uint16_t *classes = matcher->m_classes;
+  uint32_t stride = matcher->m_class_count + 1;
+  for (;;) {
+    if (t_iter->m_pattern != _RMT_NONE) {
+      uint32_t pattern = t_iter->m_pattern;
+      t_match->m_pattern = pattern;
+      t_match->m_offset =
+          t_iter->m_pos - rsv_size(matcher->m_patterns[pattern]);
+      t_iter->m_pattern = matcher->m_same[pattern];
+      return true;
+    }
+    if (t_iter->m_report != _RMT_NONE) {
+      t_iter->m_pattern = matcher->m_first[t_iter->m_report / stride];
+      t_iter->m_report = matcher->m_dict[t_iter->m_report / stride];
+      continue;
+    }
+    const unsigned char *str = (const unsigned char *)t_iter->m_text.m_str;
+    size_t size = rsv_size(t_iter->m_text);
+    size_t pos = t_iter->m_pos;
+    uint32_t state = t_iter->m_state;
+    uint32_t report = _RMT_NONE;
+    while (pos < size) {
+      state = next[state + classes[str[pos++]]];
+      report = next[state + stride - 1];
+      if (report != _RMT_NONE) {
+        break;
+      }
+    }
+    t_iter->m_pos = pos;
+    t_iter->m_state = state;
+    if (report == _RMT_NONE) {
+      return false;
+    }
+    t_iter->m_report = report;
+  }
+}
+
+#endif // RIT_MATCH_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -0,0 +1,339 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RMM_INTERNAL_DEF
+#define RMM_INTERNAL_DEF static
+#endif // RMM_INTERNAL_DEF
+
+#ifndef RIT_MMAP_H_INCLUDED
+#define RIT_MMAP_H_INCLUDED
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "rit_mmap.h needs a POSIX system"
+#endif
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rit_dyn_arr.h"
+#include "rit_str.h"
+
+// Linux only declares mremap() with _GNU_SOURCE, which does nothing once a
+// libc header was included before this one. Declare it here, so growing a
+// mapping never falls back to munmap() + mmap() on Linux.
+#ifdef __linux__
+#define _RMM_MREMAP
+#ifndef MREMAP_MAYMOVE
+#define MREMAP_MAYMOVE 1
+#endif // MREMAP_MAYMOVE
+extern void *mremap(void *t_old_addr, size_t t_old_size, size_t t_new_size,
+                    int t_flags, ...);
+#endif // __linux__
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+#define RMM_MAGIC 0x31414452 // "RDA1"
+#define RMM_VERSION 1
+
+/// @brief Header stored at the start of a file backing a rda.
+///
+/// It is padded to 64 bytes, so the elements following it stay aligned.
+struct rmm_header {
+  uint32_t m_magic;
+  uint32_t m_version;
+  uint64_t m_objsize;
+  uint64_t m_size;
+  uint64_t m_capacity;
+  uint64_t m_reserved[4];
+};
+
+/// @brief A memory mapped file, used as the context of the file backed
+/// allocator.
+struct rmm_file {
+  int m_fd;                    // Do not modify this, this is private
+  bool m_readonly;             // Do not modify this, this is private
+  size_t m_length;             // Do not modify this, this is private
+  struct rmm_header *m_header; // Do not modify this, this is private
+};
+
+/// @internal
+static inline void *_rmm_file_data(struct rmm_file *t_file) {
+  return (char *)t_file->m_header + sizeof(struct rmm_header);
+}
+
+/// @internal
+/// @brief Resize the file to hold t_size_in_bytes bytes of elements and map it
+RMM_INTERNAL_DEF inline bool _rmm_file_map(struct rmm_file *t_file,
+                                           size_t t_size_in_bytes) {
+  size_t length = sizeof(struct rmm_header) + t_size_in_bytes;
+  if (!t_file->m_readonly && ftruncate(t_file->m_fd, (off_t)length) != 0) {
+    return false;
+  }
+  if (t_file->m_header == NULL) {
+    int prot = t_file->m_readonly ? PROT_READ : PROT_READ | PROT_WRITE;
+    void *addr = mmap(NULL, length, prot, MAP_SHARED, t_file->m_fd, 0);
+    if (addr == MAP_FAILED) {
+      return false;
+    }
+    t_file->m_header = (struct rmm_header *)addr;
+  } else {
+#ifdef _RMM_MREMAP
+    void *addr =
+        mremap(t_file->m_header, t_file->m_length, length, MREMAP_MAYMOVE);
+#else
+    munmap(t_file->m_header, t_file->m_length);
+    void *addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      t_file->m_fd, 0);
+#endif // _RMM_MREMAP
+    if (addr == MAP_FAILED) {
+      return false;
+    }
+    t_file->m_header = (struct rmm_header *)addr;
+  }
+  t_file->m_length = length;
+  return true;
+}
+
+/// @internal
+static inline void *_rmm_alloc(void *t_ctx, size_t t_size_in_bytes) {
+  struct rmm_file *file = (struct rmm_file *)t_ctx;
+  if (file->m_readonly || !_rmm_file_map(file, t_size_in_bytes)) {
+    return NULL;
+  }
+  return _rmm_file_data(file);
+}
+
+/// @internal
+static inline void *_rmm_realloc(void *t_ctx, void *t_old_ptr,
+                                 size_t t_old_size_in_bytes,
+                                 size_t t_new_size_in_bytes) {
+  struct rmm_file *file = (struct rmm_file *)t_ctx;
+  (void)t_old_ptr;
+  (void)t_old_size_in_bytes;
+  if (file->m_readonly || !_rmm_file_map(file, t_new_size_in_bytes)) {
+    return NULL;
+  }
+  if (file->m_header->m_objsize) {
+    file->m_header->m_capacity =
+        t_new_size_in_bytes / file->m_header->m_objsize;
+  }
+  return _rmm_file_data(file);
+}
+
+/// @internal
+static inline void _rmm_free(void *t_ctx, void *t_ptr) {
+  struct rmm_file *file = (struct rmm_file *)t_ctx;
+  (void)t_ptr;
+  if (file->m_header) {
+    munmap(file->m_header, file->m_length);
+    file->m_header = NULL;
+  }
+  if (file->m_fd >= 0) {
+    close(file->m_fd);
+    file->m_fd = -1;
+  }
+  file->m_length = 0;
+}
+
+/// @brief Get an allocator that places the elements of a rda in the file.
+///
+/// Growing the rda resizes the file with ftruncate() and remaps it with
+/// mremap(), so pointers to elements are invalidated just like with realloc().
+static inline rda_allocator rmm_allocator(struct rmm_file *t_file) {
+  return (rda_allocator){_rmm_alloc, _rmm_free, _rmm_realloc, t_file};
+}
+
+/// @internal
+/// @return Pointer to the elements, the header has been validated
+RMM_INTERNAL_DEF inline void *
+_rmm_open_with_location(const char *t_file, int t_line,
+                        struct rmm_file *t_mmap_file, const char *t_path,
+                        size_t t_objsize, bool t_readonly) {
+  t_mmap_file->m_fd = open(t_path, t_readonly ? O_RDONLY : O_RDWR | O_CREAT,
+                           0644);
+  t_mmap_file->m_readonly = t_readonly;
+  t_mmap_file->m_length = 0;
+  t_mmap_file->m_header = NULL;
+  struct stat st;
+  if (t_mmap_file->m_fd < 0 || fstat(t_mmap_file->m_fd, &st) != 0) {
+    fprintf(stderr, "Error: failed to open %s, file: %s, line: %d\n", t_path,
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+
+  if (st.st_size == 0 && !t_readonly) {
+    // A new file, give it the default capacity of a rda
+    if (!_rmm_file_map(t_mmap_file, DEFAULT_ARR_CAP * t_objsize)) {
+      fprintf(stderr, "Error: failed to map %s, file: %s, line: %d\n", t_path,
+              t_file, t_line);
+      exit(EXIT_FAILURE);
+    }
+    t_mmap_file->m_header->m_magic = RMM_MAGIC;
+    t_mmap_file->m_header->m_version = RMM_VERSION;
+    t_mmap_file->m_header->m_objsize = t_objsize;
+    t_mmap_file->m_header->m_size = 0;
+    t_mmap_file->m_header->m_capacity = DEFAULT_ARR_CAP;
+    return _rmm_file_data(t_mmap_file);
+  }
+
+  if ((size_t)st.st_size < sizeof(struct rmm_header) ||
+      !_rmm_file_map(t_mmap_file,
+                     (size_t)st.st_size - sizeof(struct rmm_header))) {
+    fprintf(stderr, "Error: failed to map %s, file: %s, line: %d\n", t_path,
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  struct rmm_header *header = t_mmap_file->m_header;
+  if (header->m_magic != RMM_MAGIC || header->m_version != RMM_VERSION ||
+      header->m_objsize != t_objsize || header->m_size > header->m_capacity ||
+      header->m_capacity > ((size_t)st.st_size - sizeof(struct rmm_header)) /
+                               header->m_objsize) {
+    fprintf(stderr,
+            "Error: %s does not hold a rda of this type, file: %s, line: %d\n",
+            t_path, t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  return _rmm_file_data(t_mmap_file);
+}
+
+/// @brief Open a rda stored in a file, creating the file if it doesn't exist.
+///
+/// The elements are used in place, nothing gets parsed or copied. A read only
+/// rda must not be modified, growing it fails like a failed allocation.
+/// @param t_rda A rda created with `rda_struct()`, not yet initialized
+/// @param t_file A `struct rmm_file *`, to be used with `rmm_allocator()`
+#define rda_mmap_open(t_rda, t_path, t_readonly, t_file)                       \
+  do {                                                                         \
+    (t_rda).m_data = _rmm_open_with_location(                                  \
+        __FILE__, __LINE__, (t_file), (t_path), sizeof(*(t_rda).m_data),       \
+        (t_readonly));                                                         \
+    (t_rda).m_size = (size_t)(t_file)->m_header->m_size;                       \
+    (t_rda).m_capacity = (size_t)(t_file)->m_header->m_capacity;               \
+    (t_rda).m_objsize = sizeof(*(t_rda).m_data);                               \
+  } while (0)
+
+/// @brief Store the size of a rda in the header of its file and flush the
+/// mapping to the disk.
+#define rda_mmap_sync(t_rda, t_file)                                           \
+  do {                                                                         \
+    if (!(t_file)->m_readonly) {                                               \
+      (t_file)->m_header->m_size = rda_size(t_rda);                            \
+      (t_file)->m_header->m_capacity = rda_capacity(t_rda);                    \
+      msync((t_file)->m_header, (t_file)->m_length, MS_SYNC);                  \
+    }                                                                          \
+  } while (0)
+
+/// @brief Sync a rda to its file, then unmap and close the file.
+#define rda_mmap_close(t_rda, t_file)                                          \
+  do {                                                                         \
+    rda_mmap_sync(t_rda, t_file);                                              \
+    _rmm_free((t_file), (t_rda).m_data);                                       \
+    (t_rda).m_data = NULL;                                                     \
+  } while (0)
+
+/// @brief Access pattern hints for `rmm_view_open()`, they can be or'ed.
+#define RMM_ADVISE_NORMAL 0
+#define RMM_ADVISE_SEQUENTIAL 1 // Read ahead aggressively, drop pages behind
+#define RMM_ADVISE_WILLNEED 2   // Start reading the whole file in right away
+
+/// @brief A read only mapping of a whole file.
+struct rmm_view {
+  void *m_addr;    // Do not modify this, this is private
+  size_t m_length; // Do not modify this, this is private
+};
+
+/// @internal
+RMM_INTERNAL_DEF inline rsv _rmm_view_open_with_location(
+    const char *t_file, int t_line, struct rmm_view *t_view,
+    const char *t_path, int t_advice) {
+  t_view->m_addr = NULL;
+  t_view->m_length = 0;
+  int fd = open(t_path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    fprintf(stderr, "Error: failed to open %s, file: %s, line: %d\n", t_path,
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  // mmap() refuses empty mappings, an empty file is just an empty view
+  if (st.st_size == 0) {
+    close(fd);
+    return RSV_NULL;
+  }
+  void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file alive, the descriptor is not needed anymore
+  close(fd);
+  if (addr == MAP_FAILED) {
+    fprintf(stderr, "Error: failed to map %s, file: %s, line: %d\n", t_path,
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  // The hints are only advisory, failing to apply them is not an error
+  if (t_advice & RMM_ADVISE_SEQUENTIAL) {
+    madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+  }
+  if (t_advice & RMM_ADVISE_WILLNEED) {
+    madvise(addr, (size_t)st.st_size, MADV_WILLNEED);
+  }
+  t_view->m_addr = addr;
+  t_view->m_length = (size_t)st.st_size;
+  return (rsv){.m_size = t_view->m_length, .m_str = (const char *)addr};
+}
+
+/// @brief Map a file read only and get a rsv covering all of its contents.
+///
+/// Nothing gets allocated or copied, pages are read in by the kernel as the
+/// rsv is accessed. The rsv is valid until `rmm_view_close()` and is not null
+/// terminated. Changing the file on the disk while it is mapped changes what
+/// the rsv sees, truncating it makes accessing the lost pages crash.
+/// @param t_view A `struct rmm_view *`, to be passed to `rmm_view_close()`
+/// @param t_advice `RMM_ADVISE_*` flags
+/// @return rsv
+#define rmm_view_open(t_view, t_path, t_advice)                                \
+  _rmm_view_open_with_location(__FILE__, __LINE__, t_view, t_path, t_advice)
+
+/// @brief Unmap a file opened with `rmm_view_open()`, rsvs into it become
+/// invalid.
+static inline void rmm_view_close(struct rmm_view *t_view) {
+  if (t_view->m_addr) {
+    munmap(t_view->m_addr, t_view->m_length);
+  }
+  t_view->m_addr = NULL;
+  t_view->m_length = 0;
+}
+
+#endif // RIT_MMAP_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
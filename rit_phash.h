@@ -0,0 +1,330 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RPH_INTERNAL_DEF
+#define RPH_INTERNAL_DEF static
+#endif // RPH_INTERNAL_DEF
+
+#ifndef RIT_PHASH_H_INCLUDED
+#define RIT_PHASH_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rit_dyn_arr.h"
+#include "rit_str.h"
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/// @brief Returned by `rph_find()` for strings that are not in the set
+#define RPH_NONE SIZE_MAX
+
+/// @internal
+/// @brief Marks a slot without a key
+#define _RPH_EMPTY UINT32_MAX
+
+/// @brief A perfect hash table of a fixed set of strings, mapping each of
+/// them to its index in the set.
+///
+/// A key is found with one `rsv_hash_seeded()` and one comparison: the top
+/// half of the hash picks a bucket, the displacement of the bucket moves the
+/// bottom half to a slot that belongs to exactly one key. The hash is the
+/// same on every platform, so the tables can be generated ahead of time with
+/// `rph_write_c()` and compiled in as constants.
+struct rph {
+  uint64_t m_seed;                 // Do not modify this, this is private
+  size_t m_bucket_mask;            // Do not modify this, this is private
+  size_t m_slot_mask;              // Do not modify this, this is private
+  const rsv *m_keys;               // Do not modify this, this is private
+  size_t m_count;                  // Do not modify this, this is private
+  const uint32_t *m_displacements; // Do not modify this, this is private
+  const uint32_t *m_slots;         // Do not modify this, this is private
+};
+
+/// @brief Get the number of strings in the set.
+static inline size_t rph_count(const struct rph *t_rph) {
+  return t_rph->m_count;
+}
+
+/// @brief Get the string at t_index of the set.
+static inline rsv rph_key(const struct rph *t_rph, size_t t_index) {
+  return t_rph->m_keys[t_index];
+}
+
+/// @brief Find the index of a string in the set.
+/// @return The index, RPH_NONE if it is not in the set
+static inline size_t rph_find(const struct rph *t_rph, rsv t_key) {
+  if (!t_rph->m_count) {
+    return RPH_NONE;
+  }
+  uint64_t hash = rsv_hash_seeded(t_key, t_rph->m_seed);
+  uint32_t displacement =
+      t_rph->m_displacements[(hash >> 32) & t_rph->m_bucket_mask];
+  uint32_t index =
+      t_rph->m_slots[((uint32_t)hash ^ displacement) & t_rph->m_slot_mask];
+  return index != _RPH_EMPTY && rsv_eq(t_rph->m_keys[index], t_key)
+             ? index
+             : RPH_NONE;
+}
+
+/// @internal
+/// @brief Try to place every key with one seed.
+///
+/// The buckets with the most keys are placed first, each one tries
+/// displacements until all of its keys land on free slots.
+/// @return false if a bucket has no displacement that works
+RPH_INTERNAL_DEF inline bool _rph_place(struct rph *t_rph, uint64_t *t_hashes,
+                                        uint32_t *t_order,
+                                        uint32_t *t_displacements,
+                                        uint32_t *t_slots) {
+  size_t count = t_rph->m_count;
+  size_t bucket_count = t_rph->m_bucket_mask + 1;
+  size_t slot_count = t_rph->m_slot_mask + 1;
+  for (size_t i = 0; i < count; i++) {
+    t_hashes[i] = rsv_hash_seeded(t_rph->m_keys[i], t_rph->m_seed);
+    t_order[i] = (uint32_t)i;
+  }
+  // Keys by bucket, the buckets by size, biggest first. Insertion sort is
+  // fine for the size of keyword sets, the buckets are counted first.
+  uint32_t *sizes = t_displacements;
+  memset(sizes, 0, bucket_count * sizeof(uint32_t));
+  for (size_t i = 0; i < count; i++) {
+    sizes[(t_hashes[i] >> 32) & t_rph->m_bucket_mask]++;
+  }
+  for (size_t i = 1; i < count; i++) {
+    uint32_t key = t_order[i];
+    size_t bucket = (t_hashes[key] >> 32) & t_rph->m_bucket_mask;
+    size_t j = i;
+    for (; j > 0; j--) {
+      size_t other = (t_hashes[t_order[j - 1]] >> 32) & t_rph->m_bucket_mask;
+      if (sizes[other] > sizes[bucket] ||
+          (sizes[other] == sizes[bucket] && other <= bucket)) {
+        break;
+      }
+      t_order[j] = t_order[j - 1];
+    }
+    t_order[j] = key;
+  }
+  memset(t_displacements, 0, bucket_count * sizeof(uint32_t));
+  memset(t_slots, 0xff, slot_count * sizeof(uint32_t));
+  for (size_t begin = 0; begin < count;) {
+    size_t bucket = (t_hashes[t_order[begin]] >> 32) & t_rph->m_bucket_mask;
+    size_t end = begin + 1;
+    while (end < count &&
+           ((t_hashes[t_order[end]] >> 32) & t_rph->m_bucket_mask) == bucket) {
+      end++;
+    }
+    bool placed = false;
+    for (uint32_t displacement = 0; !placed && displacement < slot_count;
+         displacement++) {
+      size_t i = begin;
+      for (; i < end; i++) {
+        size_t slot = ((uint32_t)t_hashes[t_order[i]] ^ displacement) &
+                      t_rph->m_slot_mask;
+        if (t_slots[slot] != _RPH_EMPTY) {
+          break;
+        }
+        t_slots[slot] = t_order[i];
+      }
+      placed = i == end;
+      if (!placed) {
+        // Take back the keys of this bucket placed so far
+        for (size_t j = begin; j < i; j++) {
+          t_slots[((uint32_t)t_hashes[t_order[j]] ^ displacement) &
+                  t_rph->m_slot_mask] = _RPH_EMPTY;
+        }
+      } else {
+        t_displacements[bucket] = displacement;
+      }
+    }
+    if (!placed) {
+      return false;
+    }
+    begin = end;
+  }
+  return true;
+}
+
+/// @internal
+RPH_INTERNAL_DEF inline void
+_rph_build_with_location(const char *t_file, int t_line, struct rph *t_rph,
+                         const rsv *t_keys, size_t t_count,
+                         rda_allocator *t_allocator) {
+  if (t_count >= _RPH_EMPTY) {
+    fprintf(stderr, "Error: too many keys, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  // About one key per bucket and per slot, rounded up to powers of 2
+  size_t slot_count = 1;
+  while (slot_count < t_count) {
+    slot_count *= 2;
+  }
+  *t_rph = (struct rph){.m_bucket_mask = slot_count - 1,
+                        .m_keys = t_keys,
+                        .m_count = t_count};
+  uint64_t *hashes = (uint64_t *)t_allocator->alloc(
+      t_allocator->m_ctx, (t_count ? t_count : 1) * sizeof(uint64_t));
+  uint32_t *order = (uint32_t *)t_allocator->alloc(
+      t_allocator->m_ctx, (t_count ? t_count : 1) * sizeof(uint32_t));
+  uint32_t *displacements = (uint32_t *)t_allocator->alloc(
+      t_allocator->m_ctx, slot_count * sizeof(uint32_t));
+  uint32_t *slots = NULL;
+  if (!hashes || !order || !displacements) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  for (uint64_t attempt = 0;; attempt++) {
+    // A few seeds per table size, then twice the slots, which makes placing
+    // the keys easier
+    if (attempt % 16 == 0) {
+      if (attempt) {
+        t_allocator->free(t_allocator->m_ctx, slots);
+        slot_count *= 2;
+      }
+      slots = (uint32_t *)t_allocator->alloc(t_allocator->m_ctx,
+                                             slot_count * sizeof(uint32_t));
+      if (!slots) {
+        fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n",
+                t_file, t_line);
+        exit(EXIT_FAILURE);
+      }
+      t_rph->m_slot_mask = slot_count - 1;
+    }
+    t_rph->m_seed = attempt * 0x9e3779b97f4a7c15;
+    if (_rph_place(t_rph, hashes, order, displacements, slots)) {
+      break;
+    }
+    // A key that is in the set twice can never be placed
+    if (attempt == 0) {
+      for (size_t i = 0; i < t_count; i++) {
+        for (size_t j = i + 1; j < t_count; j++) {
+          if (hashes[i] == hashes[j] && rsv_eq(t_keys[i], t_keys[j])) {
+            fprintf(stderr,
+                    "Error: the key %.*s is in the set twice, file: %s, "
+                    "line: %d\n",
+                    rsv_fmt(t_keys[i]), t_file, t_line);
+            exit(EXIT_FAILURE);
+          }
+        }
+      }
+    }
+  }
+  t_allocator->free(t_allocator->m_ctx, hashes);
+  t_allocator->free(t_allocator->m_ctx, order);
+  t_rph->m_displacements = displacements;
+  t_rph->m_slots = slots;
+}
+
+/// @brief Build a perfect hash table of t_count different strings.
+///
+/// The strings are not copied, t_keys has to outlive the table, a static
+/// array of rsv_lit() for example. Building is quick for a few thousand
+/// keys, the table takes up to 16 bytes per key.
+#define rph_build(t_rph, t_keys, t_count, t_allocator)                         \
+  _rph_build_with_location(__FILE__, __LINE__, (t_rph), (t_keys), (t_count),   \
+                           (t_allocator))
+
+/// @brief Free a table built by `rph_build()`, not the keys.
+static inline void rph_free(struct rph *t_rph, rda_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, (void *)t_rph->m_displacements);
+  t_allocator->free(t_allocator->m_ctx, (void *)t_rph->m_slots);
+  *t_rph = (struct rph){};
+}
+
+/// @internal
+static inline void _rph_write_u32_arr(FILE *t_ostream, const char *t_name,
+                                      const char *t_suffix,
+                                      const uint32_t *t_arr, size_t t_size) {
+  fprintf(t_ostream, "static const uint32_t %s_%s[] = {", t_name, t_suffix);
+  for (size_t i = 0; i < t_size; i++) {
+    fprintf(t_ostream, "%s%lu,", i % 8 ? " " : "\n    ",
+            (unsigned long)t_arr[i]);
+  }
+  fprintf(t_ostream, "\n};\n");
+}
+
+/// @brief Write a table as C source, to be included where the table is used
+/// instead of building it at start up.
+///
+/// It defines `static const struct rph t_name` and the arrays behind it, the
+/// keys are written as escaped literals.
+static inline void rph_write_c(FILE *t_ostream, const struct rph *t_rph,
+                               const char *t_name) {
+  fprintf(t_ostream,
+          "// Perfect hash table of %zu keys, written by rph_write_c()\n",
+          t_rph->m_count);
+  fprintf(t_ostream, "static const rsv %s_keys[] = {\n", t_name);
+  for (size_t i = 0; i < t_rph->m_count; i++) {
+    rsv key = t_rph->m_keys[i];
+    fprintf(t_ostream, "    {.m_size = %zu, .m_str = \"", rsv_size(key));
+    for (size_t j = 0; j < rsv_size(key); j++) {
+      unsigned char ch = (unsigned char)key.m_str[j];
+      // Octal escapes stop after 3 digits, unlike hex ones
+      if (ch < 0x20 || ch >= 0x7f || ch == '"' || ch == '\\' || ch == '?') {
+        fprintf(t_ostream, "\\%03o", ch);
+      } else {
+        fputc(ch, t_ostream);
+      }
+    }
+    fprintf(t_ostream, "\"},\n");
+  }
+  if (!t_rph->m_count) {
+    fprintf(t_ostream, "    {.m_size = 0, .m_str = \"\"},\n");
+  }
+  fprintf(t_ostream, "};\n");
+  size_t bucket_count = t_rph->m_count ? t_rph->m_bucket_mask + 1 : 1;
+  size_t slot_count = t_rph->m_count ? t_rph->m_slot_mask + 1 : 1;
+  uint32_t none = 0;
+  _rph_write_u32_arr(t_ostream, t_name, "displacements",
+                     t_rph->m_count ? t_rph->m_displacements : &none,
+                     bucket_count);
+  _rph_write_u32_arr(t_ostream, t_name, "slots",
+                     t_rph->m_count ? t_rph->m_slots : &none, slot_count);
+  fprintf(t_ostream,
+          "static const struct rph %s = {\n"
+          "    .m_seed = 0x%016llxull,\n"
+          "    .m_bucket_mask = %zu,\n"
+          "    .m_slot_mask = %zu,\n"
+          "    .m_keys = %s_keys,\n"
+          "    .m_count = %zu,\n"
+          "    .m_displacements = %s_displacements,\n"
+          "    .m_slots = %s_slots,\n"
+          "};\n",
+          t_name, (unsigned long long)t_rph->m_seed, bucket_count - 1,
+          slot_count - 1, t_name, t_rph->m_count, t_name, t_name);
+}
+
+#endif // RIT_PHASH_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -0,0 +1,447 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RPL_INTERNAL_DEF
+#define RPL_INTERNAL_DEF static
+#endif // RPL_INTERNAL_DEF
+
+#ifndef RIT_PIPELINE_H_INCLUDED
+#define RIT_PIPELINE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena_allocator.h"
+#include "rit_dyn_arr.h"
+#include "rit_str.h"
+
+// Threads are only used where pthreads are, define RPL_NO_THREADS to never
+// use them
+#if !defined(RPL_NO_THREADS) && !defined(_WIN32)
+#define _RPL_THREADS
+#include <pthread.h>
+#endif
+
+// Pages of the next chunk of a mapped file are asked for ahead of time
+#if defined(__unix__) || defined(__APPLE__)
+#define _RPL_MADVISE
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+#define DEFAULT_RPL_CHUNK_SIZE ((size_t)4 << 20)
+
+/// @brief Processes one chunk, runs on a worker thread.
+/// @param t_index The chunks are numbered from 0 in the order of the input
+/// @param t_chunk Whole lines, the last one is only missing its '\n' at the
+/// end of the input
+/// @param t_arena Scratch memory, it is reset before every chunk and lives
+/// until the result was merged
+/// @return The result passed to the merge function
+typedef void *(*rpl_work_fn)(void *t_ctx, size_t t_index, rsv t_chunk,
+                             Arena *t_arena);
+/// @brief Gets the results of the chunks one at a time, in the order of the
+/// input. It may run on any of the threads, but never on two at once.
+typedef void (*rpl_merge_fn)(void *t_ctx, size_t t_index, rsv t_chunk,
+                             void *t_result);
+
+/// @brief A pipeline of worker threads processing the lines of an input.
+///
+/// The calling thread cuts the input into chunks of whole lines, reading the
+/// next chunks while the workers process the earlier ones. Each chunk is
+/// processed with its own Arena for scratch memory, so workers never share
+/// an allocator.
+struct rpl {
+  rpl_work_fn m_work;   // Do not modify this, this is private
+  rpl_merge_fn m_merge; // Do not modify this, this is private
+  void *m_ctx;          // Do not modify this, this is private
+  size_t m_threads;     // Do not modify this, this is private
+  size_t m_chunk_size;  // Do not modify this, this is private
+};
+
+/// @brief Set up a pipeline.
+/// @param t_threads The number of worker threads, 0 processes everything on
+/// the calling thread
+/// @param t_chunk_size Roughly the size of a chunk, 0 for
+/// DEFAULT_RPL_CHUNK_SIZE. A chunk grows to hold a longer line.
+static inline void rpl_init(struct rpl *t_rpl, rpl_work_fn t_work,
+                            rpl_merge_fn t_merge, void *t_ctx,
+                            size_t t_threads, size_t t_chunk_size) {
+  *t_rpl = (struct rpl){.m_work = t_work,
+                        .m_merge = t_merge,
+                        .m_ctx = t_ctx,
+                        .m_threads = t_threads,
+                        .m_chunk_size = t_chunk_size ? t_chunk_size
+                                                     : DEFAULT_RPL_CHUNK_SIZE};
+}
+
+/// @internal
+/// @brief A chunk from the time it is cut until its result is merged
+struct _rpl_slot {
+  rsv m_chunk;
+  void *m_result;
+  bool m_done;
+  Arena m_arena;
+  // Only used when reading a stream
+  char *m_buf;
+  size_t m_capacity;
+};
+
+/// @internal
+/// @brief Where the chunks come from, a rsv or a stream
+struct _rpl_source {
+  const char *m_file;
+  int m_line;
+  rsv m_text;
+  size_t m_pos;
+  FILE *m_stream;
+  rda_allocator *m_allocator;
+  // The start of a line that did not fit in the last chunk
+  rsv m_carry;
+  bool m_eof;
+  bool m_error;
+};
+
+/// @internal
+static inline void _rpl_prefetch(const char *t_str, size_t t_size) {
+#ifdef _RPL_MADVISE
+  if (t_size == 0) {
+    return;
+  }
+  uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t begin = (uintptr_t)t_str & ~(page - 1);
+  // Only a hint, memory that is not mapped from a file just ignores it
+  madvise((void *)begin, (uintptr_t)t_str + t_size - begin, MADV_WILLNEED);
+#else
+  (void)t_str;
+  (void)t_size;
+#endif // _RPL_MADVISE
+}
+
+/// @internal
+/// @brief Cut the next chunk of a rsv, ending after the first '\n' that is
+/// at least the chunk size in
+static inline bool _rpl_next_rsv_chunk(struct rpl *t_rpl,
+                                       struct _rpl_source *t_source,
+                                       struct _rpl_slot *t_slot) {
+  size_t size = rsv_size(t_source->m_text);
+  if (t_source->m_pos >= size) {
+    return false;
+  }
+  size_t end = size;
+  if (size - t_source->m_pos > t_rpl->m_chunk_size) {
+    size_t newline = rsv_find_char(
+        t_source->m_text, '\n', t_source->m_pos + t_rpl->m_chunk_size - 1);
+    if (newline != RSV_NPOS) {
+      end = newline + 1;
+    }
+  }
+  t_slot->m_chunk =
+      rsv_substr(t_source->m_text, t_source->m_pos, end - t_source->m_pos);
+  t_source->m_pos = end;
+  size_t next = size - end < t_rpl->m_chunk_size ? size - end
+                                                 : t_rpl->m_chunk_size;
+  _rpl_prefetch(t_source->m_text.m_str + end, next);
+  return true;
+}
+
+/// @internal
+/// @brief Read the next chunk of a stream into the buffer of the slot,
+/// starting with the line left over from the last chunk
+RPL_INTERNAL_DEF inline bool _rpl_next_stream_chunk(
+    struct rpl *t_rpl, struct _rpl_source *t_source, struct _rpl_slot *t_slot) {
+  rda_allocator *allocator = t_source->m_allocator;
+  size_t size = rsv_size(t_source->m_carry);
+  // The leftover is in the buffer of the last slot, which can be this one
+  bool own = size && t_slot->m_buf &&
+             t_source->m_carry.m_str >= t_slot->m_buf &&
+             t_source->m_carry.m_str < t_slot->m_buf + t_slot->m_capacity;
+  if (own) {
+    memmove(t_slot->m_buf, t_source->m_carry.m_str, size);
+  }
+  size_t capacity = size + t_rpl->m_chunk_size;
+  size_t newline = RSV_NPOS;
+  for (;;) {
+    if (t_slot->m_capacity < capacity) {
+      char *buf = (char *)(t_slot->m_buf ? allocator->realloc(
+                                               allocator->m_ctx, t_slot->m_buf,
+                                               t_slot->m_capacity, capacity)
+                                         : allocator->alloc(allocator->m_ctx,
+                                                            capacity));
+      if (!buf) {
+        fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n",
+                t_source->m_file, t_source->m_line);
+        exit(EXIT_FAILURE);
+      }
+      t_slot->m_buf = buf;
+      t_slot->m_capacity = capacity;
+    }
+    if (!own && size) {
+      memcpy(t_slot->m_buf, t_source->m_carry.m_str, size);
+    }
+    // From here on everything is in the buffer, growing it keeps it
+    own = true;
+    size_t read_size = 0;
+    if (!t_source->m_eof) {
+      read_size = fread(t_slot->m_buf + size, 1, t_slot->m_capacity - size,
+                        t_source->m_stream);
+      if (read_size < t_slot->m_capacity - size) {
+        t_source->m_eof = true;
+        t_source->m_error = ferror(t_source->m_stream);
+      }
+    }
+    // The leftover has no '\n', only the new part needs to be searched
+    newline = rsv_rfind_char((rsv){.m_size = read_size,
+                                   .m_str = t_slot->m_buf + size},
+                             '\n', RSV_NPOS);
+    newline = newline == RSV_NPOS ? RSV_NPOS : newline + size;
+    size += read_size;
+    if (newline != RSV_NPOS || t_source->m_eof) {
+      break;
+    }
+    // A line longer than the buffer
+    capacity = t_slot->m_capacity * 2;
+  }
+  if (size == 0) {
+    return false;
+  }
+  size_t end = newline == RSV_NPOS ? size : newline + 1;
+  t_slot->m_chunk = (rsv){.m_size = end, .m_str = t_slot->m_buf};
+  t_source->m_carry = (rsv){.m_size = size - end, .m_str = t_slot->m_buf + end};
+  return true;
+}
+
+/// @internal
+static inline bool _rpl_next_chunk(struct rpl *t_rpl,
+                                   struct _rpl_source *t_source,
+                                   struct _rpl_slot *t_slot) {
+  if (t_source->m_stream) {
+    return _rpl_next_stream_chunk(t_rpl, t_source, t_slot);
+  }
+  return _rpl_next_rsv_chunk(t_rpl, t_source, t_slot);
+}
+
+#ifdef _RPL_THREADS
+/// @internal
+/// @brief State shared by the threads of a run, chunk k uses slot
+/// k % m_slot_count
+struct _rpl_run {
+  struct rpl *m_rpl;
+  struct _rpl_slot *m_slots;
+  size_t m_slot_count;
+  // Chunks cut, taken by a worker and merged so far
+  size_t m_produced;
+  size_t m_taken;
+  size_t m_merged;
+  bool m_finished;
+  bool m_merging;
+  pthread_mutex_t m_lock;
+  pthread_cond_t m_work_cond;
+  pthread_cond_t m_free_cond;
+};
+
+/// @internal
+/// @brief Merge the finished chunks that are next in order, m_lock is held.
+///
+/// Only one thread merges at a time, the lock is let go while merging so the
+/// others keep taking chunks.
+static inline void _rpl_merge_ready(struct _rpl_run *t_run) {
+  if (t_run->m_merging) {
+    return;
+  }
+  t_run->m_merging = true;
+  for (;;) {
+    struct _rpl_slot *slot =
+        &t_run->m_slots[t_run->m_merged % t_run->m_slot_count];
+    if (t_run->m_merged == t_run->m_produced || !slot->m_done) {
+      break;
+    }
+    pthread_mutex_unlock(&t_run->m_lock);
+    t_run->m_rpl->m_merge(t_run->m_rpl->m_ctx, t_run->m_merged, slot->m_chunk,
+                          slot->m_result);
+    pthread_mutex_lock(&t_run->m_lock);
+    slot->m_done = false;
+    t_run->m_merged++;
+    pthread_cond_signal(&t_run->m_free_cond);
+  }
+  t_run->m_merging = false;
+}
+
+/// @internal
+static inline void *_rpl_worker(void *t_run) {
+  struct _rpl_run *run = (struct _rpl_run *)t_run;
+  struct rpl *rpl = run->m_rpl;
+  pthread_mutex_lock(&run->m_lock);
+  for (;;) {
+    while (run->m_taken == run->m_produced && !run->m_finished) {
+      pthread_cond_wait(&run->m_work_cond, &run->m_lock);
+    }
+    if (run->m_taken == run->m_produced) {
+      break;
+    }
+    size_t index = run->m_taken++;
+    struct _rpl_slot *slot = &run->m_slots[index % run->m_slot_count];
+    pthread_mutex_unlock(&run->m_lock);
+    arena_reset(&slot->m_arena);
+    slot->m_result =
+        rpl->m_work(rpl->m_ctx, index, slot->m_chunk, &slot->m_arena);
+    pthread_mutex_lock(&run->m_lock);
+    slot->m_done = true;
+    _rpl_merge_ready(run);
+  }
+  pthread_mutex_unlock(&run->m_lock);
+  return NULL;
+}
+
+/// @internal
+/// @return false if no worker could be started
+RPL_INTERNAL_DEF inline bool _rpl_run_threads(struct rpl *t_rpl,
+                                              struct _rpl_source *t_source,
+                                              struct _rpl_slot *t_slots,
+                                              size_t t_slot_count) {
+  struct _rpl_run run = {.m_rpl = t_rpl,
+                         .m_slots = t_slots,
+                         .m_slot_count = t_slot_count};
+  pthread_mutex_init(&run.m_lock, NULL);
+  pthread_cond_init(&run.m_work_cond, NULL);
+  pthread_cond_init(&run.m_free_cond, NULL);
+  pthread_t *threads = (pthread_t *)t_source->m_allocator->alloc(
+      t_source->m_allocator->m_ctx, t_rpl->m_threads * sizeof(pthread_t));
+  size_t started = 0;
+  for (; threads && started < t_rpl->m_threads; started++) {
+    if (pthread_create(&threads[started], NULL, _rpl_worker, &run)) {
+      break;
+    }
+  }
+  if (started) {
+    // This thread cuts the chunks, as far ahead as there are free slots
+    for (size_t index = 0;; index++) {
+      pthread_mutex_lock(&run.m_lock);
+      while (index - run.m_merged >= t_slot_count) {
+        pthread_cond_wait(&run.m_free_cond, &run.m_lock);
+      }
+      pthread_mutex_unlock(&run.m_lock);
+      if (!_rpl_next_chunk(t_rpl, t_source, &t_slots[index % t_slot_count])) {
+        break;
+      }
+      pthread_mutex_lock(&run.m_lock);
+      run.m_produced++;
+      pthread_cond_signal(&run.m_work_cond);
+      pthread_mutex_unlock(&run.m_lock);
+    }
+    pthread_mutex_lock(&run.m_lock);
+    run.m_finished = true;
+    pthread_cond_broadcast(&run.m_work_cond);
+    pthread_mutex_unlock(&run.m_lock);
+    for (size_t i = 0; i < started; i++) {
+      pthread_join(threads[i], NULL);
+    }
+  }
+  if (threads) {
+    t_source->m_allocator->free(t_source->m_allocator->m_ctx, threads);
+  }
+  pthread_cond_destroy(&run.m_free_cond);
+  pthread_cond_destroy(&run.m_work_cond);
+  pthread_mutex_destroy(&run.m_lock);
+  return started;
+}
+#endif // _RPL_THREADS
+
+/// @internal
+RPL_INTERNAL_DEF inline bool
+_rpl_run_with_location(const char *t_file, int t_line, struct rpl *t_rpl,
+                       rsv t_text, FILE *t_stream,
+                       rda_allocator *t_allocator) {
+  struct _rpl_source source = {.m_file = t_file,
+                               .m_line = t_line,
+                               .m_text = t_text,
+                               .m_stream = t_stream,
+                               .m_allocator = t_allocator};
+  // Two chunks per worker, one being processed and one cut ahead of time or
+  // waiting for its turn to be merged
+  size_t slot_count = t_rpl->m_threads ? t_rpl->m_threads * 2 : 1;
+  struct _rpl_slot *slots = (struct _rpl_slot *)t_allocator->alloc(
+      t_allocator->m_ctx, slot_count * sizeof(struct _rpl_slot));
+  if (!slots) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  memset(slots, 0, slot_count * sizeof(struct _rpl_slot));
+  bool threaded = false;
+#ifdef _RPL_THREADS
+  if (t_rpl->m_threads) {
+    threaded = _rpl_run_threads(t_rpl, &source, slots, slot_count);
+  }
+#endif // _RPL_THREADS
+  if (!threaded) {
+    for (size_t index = 0; _rpl_next_chunk(t_rpl, &source, &slots[0]);
+         index++) {
+      arena_reset(&slots[0].m_arena);
+      void *result = t_rpl->m_work(t_rpl->m_ctx, index, slots[0].m_chunk,
+                                   &slots[0].m_arena);
+      t_rpl->m_merge(t_rpl->m_ctx, index, slots[0].m_chunk, result);
+    }
+  }
+  for (size_t i = 0; i < slot_count; i++) {
+    arena_free(&slots[i].m_arena);
+    if (slots[i].m_buf) {
+      t_allocator->free(t_allocator->m_ctx, slots[i].m_buf);
+    }
+  }
+  t_allocator->free(t_allocator->m_ctx, slots);
+  return !source.m_error;
+}
+
+/// @brief Process the lines of a rsv, a mapped file for example.
+///
+/// The chunks point into t_text, nothing is copied. The pages of the next
+/// chunk are requested from the kernel while the current ones are processed.
+/// Returns after every chunk was merged.
+#define rpl_run(t_rpl, t_text, t_allocator)                                    \
+  _rpl_run_with_location(__FILE__, __LINE__, (t_rpl), (t_text), NULL,          \
+                         (t_allocator))
+
+/// @brief Process the lines of a stream, read in blocks of the chunk size.
+///
+/// Reading the next chunks overlaps with the workers processing the earlier
+/// ones. A line that does not fit in a chunk moves on to the next one.
+/// @return false if reading failed, the chunks read until then were merged
+#define rpl_run_stream(t_rpl, t_stream, t_allocator)                           \
+  _rpl_run_with_location(__FILE__, __LINE__, (t_rpl), RSV_NULL, (t_stream),    \
+                         (t_allocator))
+
+#endif // RIT_PIPELINE_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -0,0 +1,365 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RRP_INTERNAL_DEF
+#define RRP_INTERNAL_DEF static
+#endif // RRP_INTERNAL_DEF
+
+#ifndef RIT_ROPE_H_INCLUDED
+#define RIT_ROPE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena_allocator.h"
+#include "rit_str.h"
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/// @brief A piece of the rope, also a node of the tree.
+///
+/// The nodes form a treap ordered by position: every node's priority is at
+/// least as big as its children's, which keeps the tree balanced on average.
+struct rrp_node {
+  struct rrp_node *m_left;  // Do not modify this, this is private
+  struct rrp_node *m_right; // Do not modify this, this is private
+  size_t m_size;            // Do not modify this, this is private
+  uint64_t m_priority;      // Do not modify this, this is private
+  rsv m_piece;              // Do not modify this, this is private
+};
+
+/// @brief A string made of pieces, with O(log n) insert and erase at any
+/// position.
+///
+/// Nodes and copied text are allocated in an arena, which owns them. Erased
+/// nodes are reused by later edits, text is only released with the arena.
+struct rrp {
+  Arena *m_arena;          // Do not modify this, this is private
+  struct rrp_node *m_root; // Do not modify this, this is private
+  struct rrp_node *m_free; // Do not modify this, this is private
+  uint64_t m_seed;         // Do not modify this, this is private
+};
+
+/// @brief Iterator over the pieces of a range of a rope
+struct rrp_iter {
+  struct rrp *m_rope; // Do not modify this, this is private
+  size_t m_pos;       // Do not modify this, this is private
+  size_t m_end;       // Do not modify this, this is private
+};
+
+/// @brief Create an empty rope, its nodes and text will be allocated in
+/// t_arena.
+static inline struct rrp rrp(Arena *t_arena) {
+  return (struct rrp){.m_arena = t_arena, .m_seed = 0x9E3779B97F4A7C15};
+}
+
+/// @internal
+static inline size_t _rrp_node_size(struct rrp_node *t_node) {
+  return t_node ? t_node->m_size : 0;
+}
+
+/// @brief Number of bytes in the rope
+static inline size_t rrp_size(struct rrp *t_rope) {
+  return _rrp_node_size(t_rope->m_root);
+}
+
+/// @internal
+static inline void _rrp_update(struct rrp_node *t_node) {
+  t_node->m_size = _rrp_node_size(t_node->m_left) + t_node->m_piece.m_size +
+                   _rrp_node_size(t_node->m_right);
+}
+
+/// @internal
+static inline struct rrp_node *_rrp_node_new(struct rrp *t_rope, rsv t_piece,
+                                             uint64_t t_priority) {
+  struct rrp_node *node = t_rope->m_free;
+  if (node) {
+    t_rope->m_free = node->m_left;
+  } else {
+    node = arena_alloc_struct(t_rope->m_arena, struct rrp_node);
+  }
+  *node = (struct rrp_node){.m_size = t_piece.m_size,
+                            .m_priority = t_priority,
+                            .m_piece = t_piece};
+  return node;
+}
+
+/// @internal
+/// @brief xorshift64, the priorities only need to be unpredictable to the
+/// order of the edits
+static inline uint64_t _rrp_random(struct rrp *t_rope) {
+  t_rope->m_seed ^= t_rope->m_seed << 13;
+  t_rope->m_seed ^= t_rope->m_seed >> 7;
+  t_rope->m_seed ^= t_rope->m_seed << 17;
+  return t_rope->m_seed;
+}
+
+/// @internal
+/// @brief Split a tree into its first t_pos bytes and the rest. A piece
+/// containing t_pos is cut in two.
+RRP_INTERNAL_DEF inline void _rrp_split(struct rrp *t_rope,
+                                        struct rrp_node *t_node, size_t t_pos,
+                                        struct rrp_node **t_left,
+                                        struct rrp_node **t_right) {
+  if (t_node == NULL) {
+    *t_left = NULL;
+    *t_right = NULL;
+    return;
+  }
+  size_t left_size = _rrp_node_size(t_node->m_left);
+  size_t piece_size = t_node->m_piece.m_size;
+  if (t_pos <= left_size) {
+    _rrp_split(t_rope, t_node->m_left, t_pos, t_left, &t_node->m_left);
+    _rrp_update(t_node);
+    *t_right = t_node;
+  } else if (t_pos >= left_size + piece_size) {
+    _rrp_split(t_rope, t_node->m_right, t_pos - left_size - piece_size,
+               &t_node->m_right, t_right);
+    _rrp_update(t_node);
+    *t_left = t_node;
+  } else {
+    // The tail of the piece takes over the right subtree. Sharing the
+    // priority keeps the heap order, both halves sit where the node was.
+    size_t cut = t_pos - left_size;
+    struct rrp_node *tail = _rrp_node_new(
+        t_rope,
+        (rsv){.m_size = piece_size - cut, .m_str = t_node->m_piece.m_str + cut},
+        t_node->m_priority);
+    tail->m_right = t_node->m_right;
+    t_node->m_right = NULL;
+    t_node->m_piece.m_size = cut;
+    _rrp_update(tail);
+    _rrp_update(t_node);
+    *t_left = t_node;
+    *t_right = tail;
+  }
+}
+
+/// @internal
+/// @brief Join two trees, all of t_left comes before t_right
+RRP_INTERNAL_DEF inline struct rrp_node *_rrp_merge(struct rrp_node *t_left,
+                                                    struct rrp_node *t_right) {
+  if (t_left == NULL) {
+    return t_right;
+  }
+  if (t_right == NULL) {
+    return t_left;
+  }
+  if (t_left->m_priority >= t_right->m_priority) {
+    t_left->m_right = _rrp_merge(t_left->m_right, t_right);
+    _rrp_update(t_left);
+    return t_left;
+  }
+  t_right->m_left = _rrp_merge(t_left, t_right->m_left);
+  _rrp_update(t_right);
+  return t_right;
+}
+
+/// @internal
+/// @brief Put all the nodes of a tree on the free list
+static inline void _rrp_recycle(struct rrp *t_rope, struct rrp_node *t_node) {
+  // The free list is linked through m_left, so only the right children need
+  // to be remembered, which is done by rotating them into the left side
+  while (t_node) {
+    if (t_node->m_right) {
+      struct rrp_node *right = t_node->m_right;
+      t_node->m_right = right->m_left;
+      right->m_left = t_node;
+      t_node = right;
+      continue;
+    }
+    struct rrp_node *next = t_node->m_left;
+    t_node->m_left = t_rope->m_free;
+    t_rope->m_free = t_node;
+    t_node = next;
+  }
+}
+
+/// @internal
+RRP_INTERNAL_DEF inline void
+_rrp_insert_with_location(const char *t_file, int t_line, struct rrp *t_rope,
+                          size_t t_index, rsv t_rsv, bool t_copy) {
+  if (t_index > rrp_size(t_rope)) {
+    fprintf(stderr,
+            "Error: index out of bounds of the rope, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  if (rsv_size(t_rsv) == 0) {
+    return;
+  }
+  if (t_copy) {
+    char *text = (char *)arena_alloc(t_rope->m_arena, rsv_size(t_rsv));
+    memcpy(text, rsv_data(t_rsv), rsv_size(t_rsv));
+    t_rsv.m_str = text;
+  }
+  struct rrp_node *left, *right;
+  _rrp_split(t_rope, t_rope->m_root, t_index, &left, &right);
+  struct rrp_node *node = _rrp_node_new(t_rope, t_rsv, _rrp_random(t_rope));
+  t_rope->m_root = _rrp_merge(_rrp_merge(left, node), right);
+}
+
+/// @brief Insert a copy of a string at t_index, the copy is made in the arena.
+#define rrp_insert(t_rope, t_index, t_rsv)                                     \
+  _rrp_insert_with_location(__FILE__, __LINE__, (t_rope), (t_index), (t_rsv),  \
+                            true)
+
+/// @brief Insert a string at t_index without copying it.
+///
+/// The rope keeps pointing to the characters of t_rsv, they need to stay
+/// valid and unchanged as long as the rope is used. Handy for large inputs,
+/// like a file mapped with `rmm_view_open()`.
+#define rrp_insert_ref(t_rope, t_index, t_rsv)                                 \
+  _rrp_insert_with_location(__FILE__, __LINE__, (t_rope), (t_index), (t_rsv),  \
+                            false)
+
+/// @brief Append a copy of a string.
+#define rrp_append(t_rope, t_rsv)                                              \
+  rrp_insert((t_rope), rrp_size(t_rope), (t_rsv))
+
+/// @internal
+RRP_INTERNAL_DEF inline void
+_rrp_erase_with_location(const char *t_file, int t_line, struct rrp *t_rope,
+                         size_t t_index, size_t t_size) {
+  if (t_index > rrp_size(t_rope) || t_size > rrp_size(t_rope) - t_index) {
+    fprintf(stderr,
+            "Error: range out of bounds of the rope, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  struct rrp_node *left, *middle, *right;
+  _rrp_split(t_rope, t_rope->m_root, t_index, &left, &right);
+  _rrp_split(t_rope, right, t_size, &middle, &right);
+  _rrp_recycle(t_rope, middle);
+  t_rope->m_root = _rrp_merge(left, right);
+}
+
+/// @brief Erase t_size bytes starting at t_index.
+#define rrp_erase(t_rope, t_index, t_size)                                     \
+  _rrp_erase_with_location(__FILE__, __LINE__, (t_rope), (t_index), (t_size))
+
+/// @internal
+/// @brief Find the piece holding byte t_index.
+/// @return The rest of the piece, starting at t_index
+static inline rsv _rrp_piece_at(struct rrp *t_rope, size_t t_index) {
+  struct rrp_node *node = t_rope->m_root;
+  while (node) {
+    size_t left_size = _rrp_node_size(node->m_left);
+    if (t_index < left_size) {
+      node = node->m_left;
+    } else if (t_index < left_size + node->m_piece.m_size) {
+      size_t offset = t_index - left_size;
+      return (rsv){.m_size = node->m_piece.m_size - offset,
+                   .m_str = node->m_piece.m_str + offset};
+    } else {
+      t_index -= left_size + node->m_piece.m_size;
+      node = node->m_right;
+    }
+  }
+  return RSV_NULL;
+}
+
+/// @internal
+RRP_INTERNAL_DEF inline char _rrp_at_with_location(const char *t_file,
+                                                   int t_line,
+                                                   struct rrp *t_rope,
+                                                   size_t t_index) {
+  if (t_index >= rrp_size(t_rope)) {
+    fprintf(stderr,
+            "Error: index out of bounds of the rope, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  return rsv_front(_rrp_piece_at(t_rope, t_index));
+}
+
+/// @brief Get the byte at t_index, in O(log n).
+#define rrp_at(t_rope, t_index)                                                \
+  _rrp_at_with_location(__FILE__, __LINE__, (t_rope), (t_index))
+
+/// @internal
+RRP_INTERNAL_DEF inline struct rrp_iter
+_rrp_iter_with_location(const char *t_file, int t_line, struct rrp *t_rope,
+                        size_t t_index, size_t t_size) {
+  if (t_index > rrp_size(t_rope) || t_size > rrp_size(t_rope) - t_index) {
+    fprintf(stderr,
+            "Error: range out of bounds of the rope, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  return (struct rrp_iter){
+      .m_rope = t_rope, .m_pos = t_index, .m_end = t_index + t_size};
+}
+
+/// @brief Iterate over t_size bytes starting at t_index, as a sequence of
+/// contiguous chunks.
+///
+/// The rope must not be modified while the iterator is used.
+#define rrp_iter(t_rope, t_index, t_size)                                      \
+  _rrp_iter_with_location(__FILE__, __LINE__, (t_rope), (t_index), (t_size))
+
+/// @brief Get the next chunk of the range, every chunk takes O(log n) to find.
+/// @return false once the whole range was returned
+static inline bool rrp_iter_next(struct rrp_iter *t_iter, rsv *t_chunk) {
+  if (t_iter->m_pos >= t_iter->m_end) {
+    return false;
+  }
+  rsv chunk = _rrp_piece_at(t_iter->m_rope, t_iter->m_pos);
+  if (chunk.m_size > t_iter->m_end - t_iter->m_pos) {
+    chunk.m_size = t_iter->m_end - t_iter->m_pos;
+  }
+  t_iter->m_pos += chunk.m_size;
+  *t_chunk = chunk;
+  return true;
+}
+
+/// @brief Append t_size bytes of the rope, starting at t_index, to a rstr.
+///
+/// The rstr is grown once, then every piece is copied with a single memcpy().
+static inline void rrp_substr(struct rrp *t_rope, size_t t_index,
+                              size_t t_size, struct rstr *t_rstr,
+                              rstr_allocator *t_allocator) {
+  struct rrp_iter iter = rrp_iter(t_rope, t_index, t_size);
+  _rstr_grow(t_rstr, rstr_size(t_rstr) + t_size + 1, t_allocator);
+  rsv chunk;
+  while (rrp_iter_next(&iter, &chunk)) {
+    rstr_append_str(t_rstr, chunk, t_allocator);
+  }
+}
+
+/// @brief Append the whole rope to a rstr, making it contiguous.
+#define rrp_flatten(t_rope, t_rstr, t_allocator)                               \
+  rrp_substr((t_rope), 0, rrp_size(t_rope), (t_rstr), (t_allocator))
+
+#endif // RIT_ROPE_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -0,0 +1,635 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RSR_INTERNAL_DEF
+#define RSR_INTERNAL_DEF static
+#endif // RSR_INTERNAL_DEF
+
+#ifndef RIT_SERIAL_H_INCLUDED
+#define RIT_SERIAL_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rit_dyn_arr.h"
+#include "rit_str.h"
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+// Every record looks like this, all the integers are little endian:
+//
+//   u32 magic | u8 kind | u8 flags | u16 reserved | length fields | payload |
+//   u32 adler32 checksum of the payload
+//
+// The length fields are u64s, or LEB128 varints with `RSR_FLAG_VARINT`.
+// - RSR_KIND_ARRAY:     objsize, count, then count * objsize raw bytes
+// - RSR_KIND_STRING:    size, then the characters
+// - RSR_KIND_STRING_ARR: count, total size, count lengths, then the characters
+//   of all strings back to back
+//
+// Array elements are dumped as they are in memory, so only POD types without
+// pointers can be stored, and the files are not portable across endianness.
+
+#define RSR_MAGIC 0x31525352 // "RSR1"
+#define RSR_FLAG_VARINT 1
+
+enum rsr_kind {
+  RSR_KIND_ARRAY = 1,
+  RSR_KIND_STRING = 2,
+  RSR_KIND_STRING_ARR = 3,
+};
+
+/// @brief Writes `t_size` bytes somewhere, returns the number of bytes
+/// written.
+typedef size_t (*rsr_write_fn)(void *t_ctx, const void *t_data, size_t t_size);
+/// @brief Reads up to `t_size` bytes, returns the number of bytes read, 0 at
+/// the end of the input.
+typedef size_t (*rsr_read_fn)(void *t_ctx, void *t_data, size_t t_size);
+
+/// @brief Buffered writer, data goes out in chunks of the caller's buffer size.
+struct rsr_writer {
+  char *m_buf;          // Do not modify this, this is private
+  size_t m_capacity;    // Do not modify this, this is private
+  size_t m_size;        // Do not modify this, this is private
+  rsr_write_fn m_write; // Do not modify this, this is private
+  void *m_ctx;          // Do not modify this, this is private
+  uint32_t m_adler_a;   // Do not modify this, this is private
+  uint32_t m_adler_b;   // Do not modify this, this is private
+  bool m_varint;        // Do not modify this, this is private
+  bool m_error;         // Do not modify this, this is private
+};
+
+/// @brief Buffered reader, data comes in in chunks of the caller's buffer size.
+struct rsr_reader {
+  char *m_buf;        // Do not modify this, this is private
+  size_t m_capacity;  // Do not modify this, this is private
+  size_t m_begin;     // Do not modify this, this is private
+  size_t m_end;       // Do not modify this, this is private
+  rsr_read_fn m_read; // Do not modify this, this is private
+  void *m_ctx;        // Do not modify this, this is private
+  uint32_t m_adler_a; // Do not modify this, this is private
+  uint32_t m_adler_b; // Do not modify this, this is private
+  uint64_t m_left;    // Do not modify this, this is private
+  bool m_error;       // Do not modify this, this is private
+};
+
+/// @brief rsr_write_fn writing into a `FILE *`
+static inline size_t rsr_file_write(void *t_ctx, const void *t_data,
+                                    size_t t_size) {
+  return fwrite(t_data, 1, t_size, (FILE *)t_ctx);
+}
+/// @brief rsr_read_fn reading from a `FILE *`
+static inline size_t rsr_file_read(void *t_ctx, void *t_data, size_t t_size) {
+  return fread(t_data, 1, t_size, (FILE *)t_ctx);
+}
+
+/// @internal
+/// @brief Feed bytes into a running adler32 checksum
+static inline void _rsr_adler32(uint32_t *t_a, uint32_t *t_b,
+                                const void *t_data, size_t t_size) {
+  const unsigned char *data = (const unsigned char *)t_data;
+  uint32_t a = *t_a, b = *t_b;
+  while (t_size > 0) {
+    // 5552 is the largest block that can't overflow b before the modulo
+    size_t block = t_size < 5552 ? t_size : 5552;
+    t_size -= block;
+    for (size_t i = 0; i < block; i++) {
+      a += data[i];
+      b += a;
+    }
+    data += block;
+    a %= 65521;
+    b %= 65521;
+  }
+  *t_a = a;
+  *t_b = b;
+}
+
+static inline void rsr_writer_init(struct rsr_writer *t_writer, char *t_buf,
+                                   size_t t_capacity, rsr_write_fn t_write,
+                                   void *t_ctx, bool t_varint) {
+  *t_writer = (struct rsr_writer){.m_buf = t_buf,
+                                  .m_capacity = t_capacity,
+                                  .m_write = t_write,
+                                  .m_ctx = t_ctx,
+                                  .m_varint = t_varint};
+}
+
+/// @brief Write out everything buffered so far.
+/// @return false if any write failed since the writer was created
+static inline bool rsr_writer_flush(struct rsr_writer *t_writer) {
+  if (t_writer->m_size > 0 && !t_writer->m_error &&
+      t_writer->m_write(t_writer->m_ctx, t_writer->m_buf, t_writer->m_size) !=
+          t_writer->m_size) {
+    t_writer->m_error = true;
+  }
+  t_writer->m_size = 0;
+  return !t_writer->m_error;
+}
+
+/// @internal
+RSR_INTERNAL_DEF inline void _rsr_write_bytes(struct rsr_writer *t_writer,
+                                              const void *t_data,
+                                              size_t t_size) {
+  // Empty payloads may come with a NULL pointer
+  if (t_size == 0) {
+    return;
+  }
+  if (t_writer->m_size + t_size > t_writer->m_capacity) {
+    rsr_writer_flush(t_writer);
+    // Too big for the buffer, skip the extra copy
+    if (t_size >= t_writer->m_capacity) {
+      if (!t_writer->m_error &&
+          t_writer->m_write(t_writer->m_ctx, t_data, t_size) != t_size) {
+        t_writer->m_error = true;
+      }
+      return;
+    }
+  }
+  memcpy(t_writer->m_buf + t_writer->m_size, t_data, t_size);
+  t_writer->m_size += t_size;
+}
+
+/// @internal
+static inline void _rsr_write_payload(struct rsr_writer *t_writer,
+                                      const void *t_data, size_t t_size) {
+  _rsr_adler32(&t_writer->m_adler_a, &t_writer->m_adler_b, t_data, t_size);
+  _rsr_write_bytes(t_writer, t_data, t_size);
+}
+
+/// @internal
+static inline void _rsr_write_u32(struct rsr_writer *t_writer, uint32_t t_val) {
+  unsigned char bytes[4];
+  for (int i = 0; i < 4; i++) {
+    bytes[i] = (unsigned char)(t_val >> (8 * i));
+  }
+  _rsr_write_bytes(t_writer, bytes, 4);
+}
+
+/// @internal
+static inline void _rsr_write_len(struct rsr_writer *t_writer,
+                                  uint64_t t_val) {
+  unsigned char bytes[10];
+  size_t size = 0;
+  if (t_writer->m_varint) {
+    do {
+      bytes[size] = (unsigned char)(t_val & 0x7F);
+      t_val >>= 7;
+      if (t_val) {
+        bytes[size] |= 0x80;
+      }
+      size++;
+    } while (t_val);
+  } else {
+    for (; size < 8; size++) {
+      bytes[size] = (unsigned char)(t_val >> (8 * size));
+    }
+  }
+  _rsr_write_bytes(t_writer, bytes, size);
+}
+
+/// @internal
+static inline void _rsr_write_begin(struct rsr_writer *t_writer,
+                                    enum rsr_kind t_kind) {
+  unsigned char bytes[4] = {(unsigned char)t_kind,
+                            t_writer->m_varint ? RSR_FLAG_VARINT : 0, 0, 0};
+  _rsr_write_u32(t_writer, RSR_MAGIC);
+  _rsr_write_bytes(t_writer, bytes, 4);
+  t_writer->m_adler_a = 1;
+  t_writer->m_adler_b = 0;
+}
+
+/// @internal
+static inline void _rsr_write_end(struct rsr_writer *t_writer) {
+  _rsr_write_u32(t_writer, (t_writer->m_adler_b << 16) | t_writer->m_adler_a);
+}
+
+/// @brief Write `t_count` elements of `t_objsize` bytes as an array record.
+static inline void rsr_write_array(struct rsr_writer *t_writer,
+                                   const void *t_data, size_t t_objsize,
+                                   size_t t_count) {
+  _rsr_write_begin(t_writer, RSR_KIND_ARRAY);
+  _rsr_write_len(t_writer, t_objsize);
+  _rsr_write_len(t_writer, t_count);
+  _rsr_write_payload(t_writer, t_data, t_objsize * t_count);
+  _rsr_write_end(t_writer);
+}
+
+/// @brief Write the elements of a rda as an array record.
+#define rsr_write_rda(t_writer, t_rda)                                         \
+  rsr_write_array((t_writer), rda_data(t_rda), (t_rda).m_objsize,              \
+                  rda_size(t_rda))
+
+/// @brief Write a string record.
+static inline void rsr_write_rsv(struct rsr_writer *t_writer, rsv t_rsv) {
+  _rsr_write_begin(t_writer, RSR_KIND_STRING);
+  _rsr_write_len(t_writer, rsv_size(t_rsv));
+  _rsr_write_payload(t_writer, rsv_data(t_rsv), rsv_size(t_rsv));
+  _rsr_write_end(t_writer);
+}
+
+static inline void rsr_write_rstr(struct rsr_writer *t_writer,
+                                  struct rstr *t_rstr) {
+  rsr_write_rsv(t_writer, rsv_rstr(t_rstr));
+}
+
+/// @brief Write an array of strings as a single record.
+static inline void rsr_write_rsv_arr(struct rsr_writer *t_writer,
+                                     const rsv *t_arr, size_t t_count) {
+  uint64_t total_size = 0;
+  for (size_t i = 0; i < t_count; i++) {
+    total_size += rsv_size(t_arr[i]);
+  }
+  _rsr_write_begin(t_writer, RSR_KIND_STRING_ARR);
+  _rsr_write_len(t_writer, t_count);
+  _rsr_write_len(t_writer, total_size);
+  for (size_t i = 0; i < t_count; i++) {
+    _rsr_write_len(t_writer, rsv_size(t_arr[i]));
+  }
+  for (size_t i = 0; i < t_count; i++) {
+    _rsr_write_payload(t_writer, rsv_data(t_arr[i]), rsv_size(t_arr[i]));
+  }
+  _rsr_write_end(t_writer);
+}
+
+static inline void rsr_reader_init(struct rsr_reader *t_reader, char *t_buf,
+                                   size_t t_capacity, rsr_read_fn t_read,
+                                   void *t_ctx) {
+  *t_reader = (struct rsr_reader){.m_buf = t_buf,
+                                  .m_capacity = t_capacity,
+                                  .m_read = t_read,
+                                  .m_ctx = t_ctx,
+                                  .m_left = UINT64_MAX};
+  // The size of regular files is known, it bounds the lengths that are read
+  if (t_read == rsr_file_read) {
+    size_t left = _rstr_stream_remaining((FILE *)t_ctx);
+    t_reader->m_left = left ? left : UINT64_MAX;
+  }
+}
+
+/// @brief Tell the reader how many bytes its input still holds, lengths
+/// read from the input that are bigger are treated as malformed.
+///
+/// Done by `rsr_reader_init()` for `rsr_file_read()` on regular files.
+static inline void rsr_reader_set_input_size(struct rsr_reader *t_reader,
+                                             uint64_t t_size) {
+  t_reader->m_left = t_size;
+}
+
+/// @brief Check if the reader failed, because of a short read, a malformed
+/// record or a checksum mismatch.
+static inline bool rsr_reader_error(struct rsr_reader *t_reader) {
+  return t_reader->m_error;
+}
+
+/// @internal
+static inline void _rsr_consume_input(struct rsr_reader *t_reader,
+                                      size_t t_size) {
+  if (t_reader->m_left != UINT64_MAX) {
+    t_reader->m_left -= t_size < t_reader->m_left ? t_size : t_reader->m_left;
+  }
+}
+
+/// @internal
+/// @brief Check a length read from the input against what the input still
+/// holds, so a malformed length can't make the reader allocate or write
+/// more than that.
+/// @return false, and the reader fails, if t_count elements of t_objsize
+/// bytes can't be there
+static inline bool _rsr_check_len(struct rsr_reader *t_reader,
+                                  uint64_t t_count, size_t t_objsize) {
+  if (t_count > SIZE_MAX / (t_objsize ? t_objsize : 1)) {
+    t_reader->m_error = true;
+    return false;
+  }
+  uint64_t size = t_count * t_objsize;
+  uint64_t buffered = t_reader->m_end - t_reader->m_begin;
+  if (t_reader->m_left != UINT64_MAX && size > buffered &&
+      size - buffered > t_reader->m_left) {
+    t_reader->m_error = true;
+    return false;
+  }
+  return true;
+}
+
+/// @internal
+RSR_INTERNAL_DEF inline bool _rsr_read_bytes(struct rsr_reader *t_reader,
+                                             void *t_data, size_t t_size) {
+  char *data = (char *)t_data;
+  size_t buffered = t_reader->m_end - t_reader->m_begin;
+  if (buffered >= t_size) {
+    memcpy(data, t_reader->m_buf + t_reader->m_begin, t_size);
+    t_reader->m_begin += t_size;
+    return true;
+  }
+  memcpy(data, t_reader->m_buf + t_reader->m_begin, buffered);
+  data += buffered;
+  t_size -= buffered;
+  t_reader->m_begin = t_reader->m_end = 0;
+  // Big reads go straight into the destination, small ones refill the buffer
+  while (t_size >= t_reader->m_capacity) {
+    size_t size = t_reader->m_read(t_reader->m_ctx, data, t_size);
+    if (size == 0) {
+      t_reader->m_error = true;
+      return false;
+    }
+    _rsr_consume_input(t_reader, size);
+    data += size;
+    t_size -= size;
+  }
+  while (t_reader->m_end < t_size) {
+    size_t size =
+        t_reader->m_read(t_reader->m_ctx, t_reader->m_buf + t_reader->m_end,
+                         t_reader->m_capacity - t_reader->m_end);
+    if (size == 0) {
+      t_reader->m_error = true;
+      return false;
+    }
+    _rsr_consume_input(t_reader, size);
+    t_reader->m_end += size;
+  }
+  memcpy(data, t_reader->m_buf, t_size);
+  t_reader->m_begin = t_size;
+  return true;
+}
+
+/// @internal
+static inline bool _rsr_read_payload(struct rsr_reader *t_reader, void *t_data,
+                                     size_t t_size) {
+  if (!_rsr_read_bytes(t_reader, t_data, t_size)) {
+    return false;
+  }
+  _rsr_adler32(&t_reader->m_adler_a, &t_reader->m_adler_b, t_data, t_size);
+  return true;
+}
+
+/// @internal
+static inline bool _rsr_read_u32(struct rsr_reader *t_reader,
+                                 uint32_t *t_val) {
+  unsigned char bytes[4];
+  if (!_rsr_read_bytes(t_reader, bytes, 4)) {
+    return false;
+  }
+  *t_val = 0;
+  for (int i = 0; i < 4; i++) {
+    *t_val |= (uint32_t)bytes[i] << (8 * i);
+  }
+  return true;
+}
+
+/// @internal
+static inline bool _rsr_read_len(struct rsr_reader *t_reader, bool t_varint,
+                                 uint64_t *t_val) {
+  unsigned char byte;
+  *t_val = 0;
+  // Decode straight from the buffer when the whole length is there
+  if (t_reader->m_end - t_reader->m_begin >= 10) {
+    const unsigned char *bytes =
+        (const unsigned char *)t_reader->m_buf + t_reader->m_begin;
+    size_t size = 0;
+    if (!t_varint) {
+      for (; size < 8; size++) {
+        *t_val |= (uint64_t)bytes[size] << (8 * size);
+      }
+    } else {
+      for (int shift = 0;; shift += 7) {
+        if (shift >= 64) {
+          t_reader->m_error = true;
+          return false;
+        }
+        *t_val |= (uint64_t)(bytes[size] & 0x7F) << shift;
+        if (!(bytes[size++] & 0x80)) {
+          break;
+        }
+      }
+    }
+    t_reader->m_begin += size;
+    return true;
+  }
+  if (!t_varint) {
+    for (int i = 0; i < 8; i++) {
+      if (!_rsr_read_bytes(t_reader, &byte, 1)) {
+        return false;
+      }
+      *t_val |= (uint64_t)byte << (8 * i);
+    }
+    return true;
+  }
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (!_rsr_read_bytes(t_reader, &byte, 1)) {
+      return false;
+    }
+    *t_val |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  t_reader->m_error = true;
+  return false;
+}
+
+/// @internal
+/// @return The flags of the record, -1 on error
+static inline int _rsr_read_begin(struct rsr_reader *t_reader,
+                                  enum rsr_kind t_kind) {
+  uint32_t magic;
+  unsigned char bytes[4];
+  if (!_rsr_read_u32(t_reader, &magic) ||
+      !_rsr_read_bytes(t_reader, bytes, 4)) {
+    return -1;
+  }
+  if (magic != RSR_MAGIC || bytes[0] != t_kind) {
+    t_reader->m_error = true;
+    return -1;
+  }
+  t_reader->m_adler_a = 1;
+  t_reader->m_adler_b = 0;
+  return bytes[1];
+}
+
+/// @internal
+static inline bool _rsr_read_end(struct rsr_reader *t_reader) {
+  uint32_t checksum;
+  if (!_rsr_read_u32(t_reader, &checksum)) {
+    return false;
+  }
+  if (checksum != ((t_reader->m_adler_b << 16) | t_reader->m_adler_a)) {
+    t_reader->m_error = true;
+    return false;
+  }
+  return true;
+}
+
+/// @brief Read an array record into memory from t_allocator.
+///
+/// The elements are copied straight from the input into the allocated memory.
+/// @param t_count Gets the number of elements
+/// @return The elements, NULL on error
+RSR_INTERNAL_DEF inline void *rsr_read_array(struct rsr_reader *t_reader,
+                                             size_t t_objsize, size_t *t_count,
+                                             rda_allocator *t_allocator) {
+  *t_count = 0;
+  int flags = _rsr_read_begin(t_reader, RSR_KIND_ARRAY);
+  bool varint = flags & RSR_FLAG_VARINT;
+  uint64_t objsize, count;
+  if (flags < 0 || !_rsr_read_len(t_reader, varint, &objsize) ||
+      !_rsr_read_len(t_reader, varint, &count)) {
+    return NULL;
+  }
+  if (objsize != t_objsize) {
+    t_reader->m_error = true;
+    return NULL;
+  }
+  if (!_rsr_check_len(t_reader, count, t_objsize)) {
+    return NULL;
+  }
+  // Keep room for at least one element, like rda_init() does
+  void *data = t_allocator->alloc(t_allocator->m_ctx,
+                                  (count ? count : 1) * t_objsize);
+  if (!data) {
+    t_reader->m_error = true;
+    return NULL;
+  }
+  if (!_rsr_read_payload(t_reader, data, count * t_objsize) ||
+      !_rsr_read_end(t_reader)) {
+    t_allocator->free(t_allocator->m_ctx, data);
+    return NULL;
+  }
+  *t_count = (size_t)count;
+  return data;
+}
+
+/// @brief Read an array record into a rda that is not initialized yet.
+///
+/// On error the rda is left empty with NULL data, check `rsr_reader_error()`.
+#define rsr_read_rda(t_reader, t_rda, t_allocator)                             \
+  do {                                                                         \
+    (t_rda).m_data = rsr_read_array((t_reader), sizeof(*(t_rda).m_data),       \
+                                    &(t_rda).m_size, (t_allocator));           \
+    (t_rda).m_capacity = rda_size(t_rda) ? rda_size(t_rda) : 1;                \
+    (t_rda).m_objsize = sizeof(*(t_rda).m_data);                               \
+  } while (0)
+
+/// @brief Read a string record, replacing the contents of an initialized rstr.
+/// @return false on error
+RSR_INTERNAL_DEF inline bool rsr_read_rstr(struct rsr_reader *t_reader,
+                                           struct rstr *t_rstr,
+                                           rstr_allocator *t_allocator) {
+  int flags = _rsr_read_begin(t_reader, RSR_KIND_STRING);
+  uint64_t size;
+  if (flags < 0 || !_rsr_read_len(t_reader, flags & RSR_FLAG_VARINT, &size) ||
+      !_rsr_check_len(t_reader, size, 1)) {
+    return false;
+  }
+  // One more byte for the terminator
+  if (size == SIZE_MAX) {
+    t_reader->m_error = true;
+    return false;
+  }
+  rstr_clear(t_rstr);
+  // Without the size of the input, the string grows as the characters come
+  // in, so a malformed size fails on a short read instead of allocating it
+  while (rstr_size(t_rstr) < size) {
+    size_t done = rstr_size(t_rstr);
+    size_t end = (size_t)size;
+    if (t_reader->m_left == UINT64_MAX) {
+      size_t step = done > DEFAULT_READER_CAP ? done : DEFAULT_READER_CAP;
+      end = size - done > step ? done + step : (size_t)size;
+    }
+    rstr_reserve(t_rstr, end + 1, t_allocator);
+    char *data = _rstr_ptr(t_rstr);
+    if (!_rsr_read_payload(t_reader, data + done, end - done)) {
+      return false;
+    }
+    data[end] = '\0';
+    _rstr_set_size(t_rstr, end);
+  }
+  return _rsr_read_end(t_reader);
+}
+
+/// @brief Read an array of strings record.
+///
+/// The characters of all strings are read into one block, the rsvs point into
+/// it. Both the rsv array and the block come from t_allocator, the block is
+/// `rsv_data(result[0])` when there is at least one string.
+/// @param t_count Gets the number of strings
+/// @return The rsv array, NULL on error
+RSR_INTERNAL_DEF inline rsv *rsr_read_rsv_arr(struct rsr_reader *t_reader,
+                                              size_t *t_count,
+                                              rstr_allocator *t_allocator) {
+  *t_count = 0;
+  int flags = _rsr_read_begin(t_reader, RSR_KIND_STRING_ARR);
+  bool varint = flags & RSR_FLAG_VARINT;
+  uint64_t count, total_size;
+  if (flags < 0 || !_rsr_read_len(t_reader, varint, &count) ||
+      !_rsr_read_len(t_reader, varint, &total_size)) {
+    return NULL;
+  }
+  // Every string takes at least one byte for its length
+  if (!_rsr_check_len(t_reader, count, 1) ||
+      !_rsr_check_len(t_reader, total_size, 1)) {
+    return NULL;
+  }
+  if (count > SIZE_MAX / sizeof(rsv)) {
+    t_reader->m_error = true;
+    return NULL;
+  }
+  rsv *arr = (rsv *)t_allocator->alloc(t_allocator->m_ctx,
+                                       (count ? count : 1) * sizeof(rsv));
+  char *chars = (char *)t_allocator->alloc(t_allocator->m_ctx,
+                                           total_size ? total_size : 1);
+  uint64_t offset = 0;
+  size_t i = 0;
+  for (; arr && chars && i < count; i++) {
+    uint64_t size;
+    if (!_rsr_read_len(t_reader, varint, &size) ||
+        size > total_size - offset) {
+      break;
+    }
+    arr[i] = (rsv){.m_size = (size_t)size, .m_str = chars + offset};
+    offset += size;
+  }
+  if (!arr || !chars || i != count || offset != total_size ||
+      !_rsr_read_payload(t_reader, chars, (size_t)total_size) ||
+      !_rsr_read_end(t_reader)) {
+    t_reader->m_error = true;
+    t_allocator->free(t_allocator->m_ctx, arr);
+    t_allocator->free(t_allocator->m_ctx, chars);
+    return NULL;
+  }
+  *t_count = (size_t)count;
+  return arr;
+}
+
+#endif // RIT_SERIAL_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
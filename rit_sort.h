@@ -0,0 +1,486 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RSO_INTERNAL_DEF
+#define RSO_INTERNAL_DEF static
+#endif // RSO_INTERNAL_DEF
+
+#ifndef RIT_SORT_H_INCLUDED
+#define RIT_SORT_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rit_dyn_arr.h"
+#include "rit_str.h"
+
+// Threads are only used where pthreads are, define RSO_NO_THREADS to never
+// use them
+#if !defined(RSO_NO_THREADS) && !defined(_WIN32)
+#define _RSO_THREADS
+#include <pthread.h>
+#endif
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/// @brief Groups of strings smaller than this are sorted with multikey
+/// quicksort instead of being split into 257 buckets
+#ifndef RSO_RADIX_MIN
+#define RSO_RADIX_MIN 64
+#endif // RSO_RADIX_MIN
+
+/// @internal
+/// @brief Number of characters in a cached key
+#define _RSO_KEY_CHARS 7
+
+/// @internal
+/// @brief A group of strings that are equal up to m_depth characters
+struct _rso_task {
+  size_t m_begin;
+  size_t m_count;
+  size_t m_depth;
+};
+
+/// @internal
+/// @brief The memory a sort works in, t_tmp and t_keys as big as the array
+struct _rso_ctx {
+  rsv *m_arr;
+  rsv *m_tmp;
+  uint16_t *m_bytes;
+  uint64_t *m_keys;
+};
+
+/// @internal
+/// @brief The 7 characters at t_depth as a big endian integer, followed by
+/// how many of them are part of the string.
+///
+/// Comparing two keys is the same as comparing the 7 characters, a string
+/// that ends first is smaller even if the other one goes on with zeros.
+static inline uint64_t _rso_key(rsv t_rsv, size_t t_depth) {
+  size_t left = t_depth < rsv_size(t_rsv) ? rsv_size(t_rsv) - t_depth : 0;
+  const unsigned char *str = (const unsigned char *)t_rsv.m_str + t_depth;
+#if defined(__GNUC__) &&                                                       \
+    (!defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  if (left >= 8) {
+    uint64_t chunk;
+    memcpy(&chunk, str, 8);
+    return (__builtin_bswap64(chunk) & ~(uint64_t)0xff) | _RSO_KEY_CHARS;
+  }
+#endif
+  size_t count = left < _RSO_KEY_CHARS ? left : _RSO_KEY_CHARS;
+  uint64_t key = 0;
+  for (size_t i = 0; i < _RSO_KEY_CHARS; i++) {
+    key = key << 8 | (i < count ? str[i] : 0);
+  }
+  return key << 8 | count;
+}
+
+/// @internal
+/// @brief Compare two strings equal up to t_depth, t_key and t_key_other are
+/// their keys at t_depth
+static inline bool _rso_less(rsv t_rsv, uint64_t t_key, rsv t_rsv_other,
+                             uint64_t t_key_other, size_t t_depth) {
+  if (t_key != t_key_other) {
+    return t_key < t_key_other;
+  }
+  if ((t_key & 0xff) < _RSO_KEY_CHARS) {
+    return false;
+  }
+  return rsv_cmp(rsv_substr(t_rsv, t_depth + _RSO_KEY_CHARS, RSV_NPOS),
+                 rsv_substr(t_rsv_other, t_depth + _RSO_KEY_CHARS,
+                            RSV_NPOS)) < 0;
+}
+
+/// @internal
+static inline void _rso_swap(rsv *t_arr, uint64_t *t_keys, size_t t_index,
+                             size_t t_index_other) {
+  rsv tmp = t_arr[t_index];
+  t_arr[t_index] = t_arr[t_index_other];
+  t_arr[t_index_other] = tmp;
+  uint64_t key = t_keys[t_index];
+  t_keys[t_index] = t_keys[t_index_other];
+  t_keys[t_index_other] = key;
+}
+
+/// @internal
+/// @brief Multikey quicksort on cached keys of 7 characters.
+///
+/// The strings are partitioned into smaller, equal and bigger keys than a
+/// pivot. Only the equal ones need the next characters, the others are
+/// sorted again on the keys they already have.
+RSO_INTERNAL_DEF inline void _rso_mkqs(rsv *t_arr, uint64_t *t_keys,
+                                       size_t t_count, size_t t_depth,
+                                       bool t_cached) {
+  for (;;) {
+    if (t_count <= 1) {
+      return;
+    }
+    if (!t_cached) {
+      for (size_t i = 0; i < t_count; i++) {
+        t_keys[i] = _rso_key(t_arr[i], t_depth);
+      }
+    }
+    if (t_count <= 8) {
+      for (size_t i = 1; i < t_count; i++) {
+        rsv str = t_arr[i];
+        uint64_t key = t_keys[i];
+        size_t j = i;
+        for (; j > 0 &&
+               _rso_less(str, key, t_arr[j - 1], t_keys[j - 1], t_depth);
+             j--) {
+          t_arr[j] = t_arr[j - 1];
+          t_keys[j] = t_keys[j - 1];
+        }
+        t_arr[j] = str;
+        t_keys[j] = key;
+      }
+      return;
+    }
+    // Median of three keys
+    uint64_t a = t_keys[0], b = t_keys[t_count / 2], c = t_keys[t_count - 1];
+    uint64_t pivot = a < b ? (b < c ? b : (a < c ? c : a))
+                           : (a < c ? a : (b < c ? c : b));
+    // [0, less) < pivot, [less, i) == pivot, (greater, t_count) > pivot
+    size_t less = 0, i = 0, greater = t_count;
+    while (i < greater) {
+      if (t_keys[i] < pivot) {
+        _rso_swap(t_arr, t_keys, less++, i++);
+      } else if (t_keys[i] > pivot) {
+        _rso_swap(t_arr, t_keys, i, --greater);
+      } else {
+        i++;
+      }
+    }
+    _rso_mkqs(t_arr, t_keys, less, t_depth, true);
+    _rso_mkqs(t_arr + greater, t_keys + greater, t_count - greater, t_depth,
+              true);
+    if ((pivot & 0xff) < _RSO_KEY_CHARS) {
+      // The strings ended inside of the key, they are all equal
+      return;
+    }
+    t_arr += less;
+    t_keys += less;
+    t_count = greater - less;
+    t_depth += _RSO_KEY_CHARS;
+    t_cached = false;
+  }
+}
+
+/// @internal
+/// @brief Distribute a group of strings by their character at *t_depth, 0
+/// for the strings that end there and 1 + the character for the others.
+///
+/// Characters all the strings share are skipped first, *t_depth is moved
+/// past them.
+/// @param t_starts Gets where each of the 257 buckets starts, and the end
+/// @return false if all the strings are equal
+static inline bool _rso_distribute(struct _rso_ctx *t_ctx, size_t t_begin,
+                                   size_t t_count, size_t *t_depth,
+                                   size_t t_starts[258]) {
+  rsv *arr = t_ctx->m_arr + t_begin;
+  uint16_t *bytes = t_ctx->m_bytes + t_begin;
+  size_t counts[257];
+  for (;;) {
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < t_count; i++) {
+      uint16_t byte =
+          *t_depth < rsv_size(arr[i])
+              ? (uint16_t)((unsigned char)arr[i].m_str[*t_depth] + 1)
+              : 0;
+      bytes[i] = byte;
+      counts[byte]++;
+    }
+    if (counts[bytes[0]] != t_count) {
+      break;
+    }
+    if (bytes[0] == 0) {
+      return false;
+    }
+    (*t_depth)++;
+  }
+  t_starts[0] = t_begin;
+  for (size_t i = 0; i < 257; i++) {
+    t_starts[i + 1] = t_starts[i] + counts[i];
+  }
+  size_t next[257];
+  for (size_t i = 0; i < 257; i++) {
+    next[i] = t_starts[i] - t_begin;
+  }
+  rsv *tmp = t_ctx->m_tmp + t_begin;
+  for (size_t i = 0; i < t_count; i++) {
+    tmp[next[bytes[i]]++] = arr[i];
+  }
+  memcpy(arr, tmp, t_count * sizeof(rsv));
+  return true;
+}
+
+/// @internal
+/// @brief MSD radix sort of a group of strings equal up to t_depth.
+///
+/// The groups left to sort are kept on a stack instead of recursing, long
+/// shared prefixes can't overflow the call stack.
+RSO_INTERNAL_DEF inline void _rso_sort_range(struct _rso_ctx *t_ctx,
+                                             size_t t_begin, size_t t_count,
+                                             size_t t_depth,
+                                             rda_allocator *t_allocator) {
+  rda_struct(struct _rso_task) tasks;
+  rda_init(tasks, 0, sizeof(struct _rso_task), t_allocator);
+  rda_push_back(tasks,
+                ((struct _rso_task){.m_begin = t_begin,
+                                    .m_count = t_count,
+                                    .m_depth = t_depth}),
+                t_allocator);
+  while (rda_size(tasks)) {
+    struct _rso_task task = rda_back(tasks);
+    rda_pop_back(tasks);
+    if (task.m_count < RSO_RADIX_MIN) {
+      _rso_mkqs(t_ctx->m_arr + task.m_begin, t_ctx->m_keys + task.m_begin,
+                task.m_count, task.m_depth, false);
+      continue;
+    }
+    size_t starts[258];
+    if (!_rso_distribute(t_ctx, task.m_begin, task.m_count, &task.m_depth,
+                         starts)) {
+      continue;
+    }
+    // Bucket 0 is the strings that ended, they are equal
+    for (size_t i = 1; i < 257; i++) {
+      if (starts[i + 1] - starts[i] > 1) {
+        rda_push_back(tasks,
+                      ((struct _rso_task){.m_begin = starts[i],
+                                          .m_count = starts[i + 1] - starts[i],
+                                          .m_depth = task.m_depth + 1}),
+                      t_allocator);
+      }
+    }
+  }
+  rda_free(tasks, t_allocator);
+}
+
+/// @internal
+static inline void _rso_ctx_init(const char *t_file, int t_line,
+                                 struct _rso_ctx *t_ctx, rsv *t_arr,
+                                 size_t t_count, rda_allocator *t_allocator) {
+  size_t count = t_count ? t_count : 1;
+  t_ctx->m_arr = t_arr;
+  t_ctx->m_tmp =
+      (rsv *)t_allocator->alloc(t_allocator->m_ctx, count * sizeof(rsv));
+  t_ctx->m_bytes = (uint16_t *)t_allocator->alloc(t_allocator->m_ctx,
+                                                  count * sizeof(uint16_t));
+  t_ctx->m_keys = (uint64_t *)t_allocator->alloc(t_allocator->m_ctx,
+                                                 count * sizeof(uint64_t));
+  if (!t_ctx->m_tmp || !t_ctx->m_bytes || !t_ctx->m_keys) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// @internal
+static inline void _rso_ctx_free(struct _rso_ctx *t_ctx,
+                                 rda_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, t_ctx->m_tmp);
+  t_allocator->free(t_allocator->m_ctx, t_ctx->m_bytes);
+  t_allocator->free(t_allocator->m_ctx, t_ctx->m_keys);
+}
+
+/// @internal
+RSO_INTERNAL_DEF inline void
+_rso_sort_with_location(const char *t_file, int t_line, rsv *t_arr,
+                        size_t t_count, rda_allocator *t_allocator) {
+  struct _rso_ctx ctx;
+  _rso_ctx_init(t_file, t_line, &ctx, t_arr, t_count, t_allocator);
+  _rso_sort_range(&ctx, 0, t_count, 0, t_allocator);
+  _rso_ctx_free(&ctx, t_allocator);
+}
+
+/// @brief Sort an array of rsv, in the order of `rsv_cmp()`.
+///
+/// Large groups of strings are split by one character at a time into 257
+/// buckets, small groups are sorted with multikey quicksort on keys of 7
+/// characters, so most comparisons don't touch the strings. Only the rsv
+/// are moved, the strings are only read. Equal strings may change order.
+#define rso_sort(t_arr, t_count, t_allocator)                                  \
+  _rso_sort_with_location(__FILE__, __LINE__, (t_arr), (t_count),              \
+                          (t_allocator))
+
+/// @brief Sort a rda of rsv.
+#define rso_sort_rda(t_rda, t_allocator)                                       \
+  _rso_sort_with_location(__FILE__, __LINE__, (t_rda).m_data,                  \
+                          rda_size(t_rda), (t_allocator))
+
+#ifdef _RSO_THREADS
+/// @internal
+/// @brief Shared by the threads of a parallel sort
+struct _rso_shared {
+  struct _rso_ctx *m_ctx;
+  struct _rso_task *m_tasks;
+  size_t m_task_count;
+  size_t m_next_task;
+  rda_allocator *m_allocator;
+};
+
+/// @internal
+/// @brief Take buckets until there are none left
+static inline void *_rso_worker(void *t_shared) {
+  struct _rso_shared *shared = (struct _rso_shared *)t_shared;
+  for (;;) {
+    size_t index = __atomic_fetch_add(&shared->m_next_task, 1,
+                                      __ATOMIC_RELAXED);
+    if (index >= shared->m_task_count) {
+      return NULL;
+    }
+    struct _rso_task task = shared->m_tasks[index];
+    _rso_sort_range(shared->m_ctx, task.m_begin, task.m_count, task.m_depth,
+                    shared->m_allocator);
+  }
+}
+#endif // _RSO_THREADS
+
+/// @internal
+RSO_INTERNAL_DEF inline void
+_rso_sort_parallel_with_location(const char *t_file, int t_line, rsv *t_arr,
+                                 size_t t_count, size_t t_threads,
+                                 rda_allocator *t_allocator) {
+  struct _rso_ctx ctx;
+  _rso_ctx_init(t_file, t_line, &ctx, t_arr, t_count, t_allocator);
+  size_t depth = 0;
+  size_t starts[258];
+#ifdef _RSO_THREADS
+  if (t_threads > 1 && t_count >= RSO_RADIX_MIN &&
+      _rso_distribute(&ctx, 0, t_count, &depth, starts)) {
+    // The first split is done here, its buckets are sorted by the threads,
+    // biggest first so a big one doesn't start last
+    struct _rso_task tasks[256];
+    size_t task_count = 0;
+    for (size_t i = 1; i < 257; i++) {
+      size_t count = starts[i + 1] - starts[i];
+      if (count > 1) {
+        size_t j = task_count++;
+        for (; j > 0 && tasks[j - 1].m_count < count; j--) {
+          tasks[j] = tasks[j - 1];
+        }
+        tasks[j] = (struct _rso_task){
+            .m_begin = starts[i], .m_count = count, .m_depth = depth + 1};
+      }
+    }
+    struct _rso_shared shared = {.m_ctx = &ctx,
+                                 .m_tasks = tasks,
+                                 .m_task_count = task_count,
+                                 .m_allocator = t_allocator};
+    if (t_threads > task_count) {
+      t_threads = task_count;
+    }
+    pthread_t threads[256];
+    size_t started = 0;
+    // This thread is one of the workers
+    for (; started + 1 < t_threads; started++) {
+      if (pthread_create(&threads[started], NULL, _rso_worker, &shared)) {
+        break;
+      }
+    }
+    _rso_worker(&shared);
+    for (size_t i = 0; i < started; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    _rso_ctx_free(&ctx, t_allocator);
+    return;
+  }
+#endif // _RSO_THREADS
+  (void)t_threads;
+  (void)starts;
+  _rso_sort_range(&ctx, 0, t_count, depth, t_allocator);
+  _rso_ctx_free(&ctx, t_allocator);
+}
+
+/// @brief Same as `rso_sort()`, with the buckets of the first split sorted by
+/// up to t_threads threads.
+///
+/// Without pthreads, or with RSO_NO_THREADS defined, it sorts in the calling
+/// thread. t_allocator is used from all the threads.
+#define rso_sort_parallel(t_arr, t_count, t_threads, t_allocator)              \
+  _rso_sort_parallel_with_location(__FILE__, __LINE__, (t_arr), (t_count),     \
+                                   (t_threads), (t_allocator))
+
+/// @internal
+/// @brief Number of characters at the start of both strings that are equal
+static inline size_t _rso_lcp(rsv t_rsv, rsv t_rsv_other) {
+  size_t size = rsv_size(t_rsv) < rsv_size(t_rsv_other)
+                    ? rsv_size(t_rsv)
+                    : rsv_size(t_rsv_other);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t chunk, chunk_other;
+    memcpy(&chunk, t_rsv.m_str + i, 8);
+    memcpy(&chunk_other, t_rsv_other.m_str + i, 8);
+    if (chunk != chunk_other) {
+      break;
+    }
+  }
+  while (i < size && t_rsv.m_str[i] == t_rsv_other.m_str[i]) {
+    i++;
+  }
+  return i;
+}
+
+/// @brief Remove the repeated strings of a sorted array, the first of the
+/// equal strings is kept.
+///
+/// Every string is compared to the one before it only once, the length of
+/// the common prefix tells whether they are equal.
+/// @param t_lcp NULL, or room for t_count sizes, t_lcp[i] gets the number of
+/// characters kept string i shares with kept string i - 1, 0 for the first
+/// @return The number of strings kept
+static inline size_t rso_dedup(rsv *t_arr, size_t t_count, size_t *t_lcp) {
+  if (t_count == 0) {
+    return 0;
+  }
+  size_t kept = 1;
+  if (t_lcp) {
+    t_lcp[0] = 0;
+  }
+  for (size_t i = 1; i < t_count; i++) {
+    size_t lcp = _rso_lcp(t_arr[kept - 1], t_arr[i]);
+    if (lcp == rsv_size(t_arr[i]) && lcp == rsv_size(t_arr[kept - 1])) {
+      continue;
+    }
+    if (t_lcp) {
+      t_lcp[kept] = lcp;
+    }
+    t_arr[kept++] = t_arr[i];
+  }
+  return kept;
+}
+
+#endif // RIT_SORT_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
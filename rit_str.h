@@ -10,10 +10,17 @@
 
 #define RSV_NULL (rsv){.m_size = 0, .m_str = ""}
 
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 // Disable MSVC warning 4702: unreachable code
 #pragma warning(disable : 4702)
@@ -35,23 +42,105 @@ typedef struct {
 } rstr_allocator;
 #endif // RIT_DYN_ARR_H_INCLUDED
 
+/// @brief Number of characters a rstr can store without allocating, 22 with a
+/// 64 bit size_t
+#define RSTR_SSO_CAP (sizeof(size_t) * 3 - 2)
+
 /// @brief Owning reference to a string
+///
+/// Short strings are stored inline, with their size kept in the last byte.
+/// Longer strings are stored in memory from the allocator, in that case the
+/// highest bit of the last byte is set, which is also the highest bit of
+/// m_capacity. A zero initialized rstr is a valid empty string.
+///
+/// The characters of a short string live in the struct itself, so pointers
+/// and views into it are only valid as long as the struct does not move.
+///
+/// With RSTR_CACHE_HASH defined, a rstr also remembers its `rstr_hash()`, 0
+/// meaning that it is not known. Every function changing the string forgets
+/// it, including getting a writable character with `rstr_at()`.
 struct rstr {
-  size_t m_size;     // Do not modify this, this is private
-  size_t m_capacity; // Do not modify this, this is private
-  char *m_data;      // Do not modify this, this is private
+  union {
+    struct {
+      char *m_data;      // Do not modify this, this is private
+      size_t m_size;     // Do not modify this, this is private
+      size_t m_capacity; // Do not modify this, this is private
+    } m_heap;
+    char m_inline[sizeof(size_t) * 3]; // Do not modify this, this is private
+  };
+#ifdef RSTR_CACHE_HASH
+  uint64_t m_hash; // Do not modify this, this is private
+#endif // RSTR_CACHE_HASH
 };
 
+/// @internal
+/// @brief The byte holding either the inline size or the heap flag
+#define _RSTR_TAG (sizeof(size_t) * 3 - 1)
+/// @internal
+/// @brief Heap capacities are stored so that the heap flag is set in the tag
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define _RSTR_CAP_ENCODE(t_capacity) (((t_capacity) << 8) | 0x80)
+#define _RSTR_CAP_DECODE(t_capacity) ((t_capacity) >> 8)
+#else
+#define _RSTR_CAP_ENCODE(t_capacity)                                           \
+  ((t_capacity) | ((size_t)1 << (sizeof(size_t) * 8 - 1)))
+#define _RSTR_CAP_DECODE(t_capacity) ((t_capacity) & (SIZE_MAX >> 1))
+#endif
+
 /// @brief Non owning reference to a string
 typedef struct {
   size_t m_size;     // Do not modify this, this is private
   const char *m_str; // Do not modify this, this is private
 } rsv;
 
-static inline size_t rstr_size(struct rstr *t_rstr) { return t_rstr->m_size; }
+/// @internal
+static inline bool _rstr_is_heap(const struct rstr *t_rstr) {
+  return (unsigned char)t_rstr->m_inline[_RSTR_TAG] & 0x80;
+}
 
+/// @internal
+/// @brief Get a mutable pointer to the characters
+static inline char *_rstr_ptr(struct rstr *t_rstr) {
+  return _rstr_is_heap(t_rstr) ? t_rstr->m_heap.m_data : t_rstr->m_inline;
+}
+
+/// @internal
+/// @brief Forget the cached hash, the string is about to change
+static inline void _rstr_hash_reset(struct rstr *t_rstr) {
+#ifdef RSTR_CACHE_HASH
+  t_rstr->m_hash = 0;
+#else
+  (void)t_rstr;
+#endif // RSTR_CACHE_HASH
+}
+
+/// @internal
+/// @brief Get a pointer to the characters that may be written through
+static inline char *_rstr_mut_ptr(struct rstr *t_rstr) {
+  _rstr_hash_reset(t_rstr);
+  return _rstr_ptr(t_rstr);
+}
+
+/// @internal
+/// @brief Set the size, the null terminator is not written
+static inline void _rstr_set_size(struct rstr *t_rstr, size_t t_size) {
+  _rstr_hash_reset(t_rstr);
+  if (_rstr_is_heap(t_rstr)) {
+    t_rstr->m_heap.m_size = t_size;
+  } else {
+    t_rstr->m_inline[_RSTR_TAG] = (char)t_size;
+  }
+}
+
+static inline size_t rstr_size(struct rstr *t_rstr) {
+  return _rstr_is_heap(t_rstr) ? t_rstr->m_heap.m_size
+                               : (size_t)t_rstr->m_inline[_RSTR_TAG];
+}
+
+/// @brief Number of bytes the string can hold, including the null terminator.
 static inline size_t rstr_capacity(struct rstr *t_rstr) {
-  return t_rstr->m_capacity;
+  return _rstr_is_heap(t_rstr) ? _RSTR_CAP_DECODE(t_rstr->m_heap.m_capacity)
+                               : RSTR_SSO_CAP + 1;
 }
 
 static inline size_t rsv_size(rsv t_rsv) { return t_rsv.m_size; }
@@ -73,8 +162,13 @@ static inline rsv rsv_cstr(char *t_cstr, size_t t_len) {
   return (rsv){.m_size = len, .m_str = t_cstr};
 }
 /// @brief Create a rsv from rstr
+///
+/// A view of a short string points into the struct rstr itself, up to
+/// RSTR_SSO_CAP characters are stored inline. It dangles once the struct
+/// moves, when a rda of rstr grows, with `rstr_swap()` or when the rstr is
+/// returned by value, not only when the string changes or is freed.
 static inline rsv rsv_rstr(struct rstr *t_rstr) {
-  return (rsv){.m_size = rstr_size(t_rstr), .m_str = t_rstr->m_data};
+  return (rsv){.m_size = rstr_size(t_rstr), .m_str = _rstr_ptr(t_rstr)};
 }
 /// @brief Create a rsv from rsv
 static inline rsv rsv_rsv(rsv t_rsv) {
@@ -119,26 +213,1491 @@ static inline const char *rsv_end(rsv t_rsv) {
   return &(t_rsv.m_str[rsv_size(t_rsv)]);
 }
 
-/// @brief Get the first element of an rsv
-static inline char rsv_front(rsv t_rsv) { return t_rsv.m_str[0]; }
-/// @brief Get the last element of an rsv
-static inline char rsv_back(rsv t_rsv) {
-  return t_rsv.m_str[rsv_size(t_rsv) - 1];
+/// @brief Get the first element of an rsv
+static inline char rsv_front(rsv t_rsv) { return t_rsv.m_str[0]; }
+/// @brief Get the last element of an rsv
+static inline char rsv_back(rsv t_rsv) {
+  return t_rsv.m_str[rsv_size(t_rsv) - 1];
+}
+
+/// @brief Returned by the rsv search functions when nothing was found
+#define RSV_NPOS SIZE_MAX
+
+// SSE2 is part of x86-64, AVX2 is only used after checking the cpu at run time.
+// Define RSV_NO_SIMD to always use the portable code.
+#if !defined(RSV_NO_SIMD) &&                                                   \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define _RSV_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && defined(__x86_64__)
+#define _RSV_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
+/// @internal
+/// @brief Index of the lowest set bit, t_mask must not be 0
+static inline unsigned _rsv_ctz(uint32_t t_mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, t_mask);
+  return (unsigned)index;
+#else
+  return (unsigned)__builtin_ctz(t_mask);
+#endif // _MSC_VER
+}
+
+/// @internal
+/// @brief Index of the highest set bit, t_mask must not be 0
+static inline unsigned _rsv_clz_index(uint32_t t_mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse(&index, t_mask);
+  return (unsigned)index;
+#else
+  return 31u - (unsigned)__builtin_clz(t_mask);
+#endif // _MSC_VER
+}
+
+#ifdef _RSV_AVX2
+/// @internal
+static inline bool _rsv_has_avx2(void) {
+  // Threads may race to fill it in, they all store the same value
+  static int has_avx2 = -1;
+  int cached = __atomic_load_n(&has_avx2, __ATOMIC_RELAXED);
+  if (cached < 0) {
+    cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    __atomic_store_n(&has_avx2, cached, __ATOMIC_RELAXED);
+  }
+  return cached;
+}
+#endif // _RSV_AVX2
+
+/// @brief Find the first occurrence of a character, starting at t_pos.
+///
+/// memchr() from the C library is already vectorized and picks the widest
+/// instructions the cpu supports, so it is used as is.
+/// @return The index of the character or RSV_NPOS
+static inline size_t rsv_find_char(rsv t_rsv, char t_ch, size_t t_pos) {
+  if (t_pos >= rsv_size(t_rsv)) {
+    return RSV_NPOS;
+  }
+  const char *found = (const char *)memchr(t_rsv.m_str + t_pos, t_ch,
+                                           rsv_size(t_rsv) - t_pos);
+  return found ? (size_t)(found - t_rsv.m_str) : RSV_NPOS;
+}
+
+/// @brief Find the last occurrence of a character at or before t_pos.
+/// @param t_pos RSV_NPOS to search the whole rsv
+/// @return The index of the character or RSV_NPOS
+static inline size_t rsv_rfind_char(rsv t_rsv, char t_ch, size_t t_pos) {
+  if (rsv_size(t_rsv) == 0) {
+    return RSV_NPOS;
+  }
+  // One past the last index that gets checked
+  size_t end = t_pos < rsv_size(t_rsv) ? t_pos + 1 : rsv_size(t_rsv);
+#ifdef _RSV_SSE2
+  __m128i needle = _mm_set1_epi8(t_ch);
+  while (end >= 16) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(t_rsv.m_str + end - 16));
+    uint32_t mask =
+        (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+    if (mask) {
+      return end - 16 + _rsv_clz_index(mask);
+    }
+    end -= 16;
+  }
+#endif // _RSV_SSE2
+  while (end > 0) {
+    end--;
+    if (t_rsv.m_str[end] == t_ch) {
+      return end;
+    }
+  }
+  return RSV_NPOS;
+}
+
+#ifdef _RSV_AVX2
+/// @internal
+__attribute__((target("avx2"))) static inline size_t
+_rsv_count_char_avx2(const char *t_str, size_t t_size, char t_ch) {
+  __m256i needle = _mm256_set1_epi8(t_ch);
+  size_t count = 0;
+  size_t i = 0;
+  while (i + 32 <= t_size) {
+    // Every matching byte adds 1 to its lane, the lanes are summed before
+    // they can overflow
+    __m256i counts = _mm256_setzero_si256();
+    for (size_t round = 0; round < 255 && i + 32 <= t_size; round++, i += 32) {
+      __m256i block = _mm256_loadu_si256((const __m256i *)(t_str + i));
+      counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(block, needle));
+    }
+    __m256i sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+    count += (size_t)_mm256_extract_epi64(sums, 0) +
+             (size_t)_mm256_extract_epi64(sums, 1) +
+             (size_t)_mm256_extract_epi64(sums, 2) +
+             (size_t)_mm256_extract_epi64(sums, 3);
+  }
+  for (; i < t_size; i++) {
+    count += t_str[i] == t_ch;
+  }
+  return count;
+}
+#endif // _RSV_AVX2
+
+/// @brief Count the occurrences of a character.
+static inline size_t rsv_count_char(rsv t_rsv, char t_ch) {
+  const char *str = t_rsv.m_str;
+  size_t size = rsv_size(t_rsv);
+  size_t count = 0;
+  size_t i = 0;
+#ifdef _RSV_AVX2
+  if (_rsv_has_avx2()) {
+    return _rsv_count_char_avx2(str, size, t_ch);
+  }
+#endif // _RSV_AVX2
+#ifdef _RSV_SSE2
+  __m128i needle = _mm_set1_epi8(t_ch);
+  while (i + 16 <= size) {
+    __m128i counts = _mm_setzero_si128();
+    for (size_t round = 0; round < 255 && i + 16 <= size; round++, i += 16) {
+      __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+      counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(block, needle));
+    }
+    __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+    count += (size_t)_mm_cvtsi128_si32(sums) +
+             (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+  }
+#endif // _RSV_SSE2
+  for (; i < size; i++) {
+    count += str[i] == t_ch;
+  }
+  return count;
+}
+
+#ifdef _RSV_AVX2
+/// @internal
+/// @brief Compare the first and last byte of the needle at 32 positions at
+/// once, only positions where both match get compared fully.
+/// @return The index of the match, or the first position not checked yet
+/// with t_found set to false
+__attribute__((target("avx2"))) static inline size_t
+_rsv_find_avx2(const char *t_str, size_t t_size, const char *t_needle,
+               size_t t_needle_size, size_t t_pos, bool *t_found) {
+  __m256i first = _mm256_set1_epi8(t_needle[0]);
+  __m256i last = _mm256_set1_epi8(t_needle[t_needle_size - 1]);
+  size_t i = t_pos;
+  for (; i + t_needle_size - 1 + 32 <= t_size; i += 32) {
+    __m256i block_first = _mm256_loadu_si256((const __m256i *)(t_str + i));
+    __m256i block_last = _mm256_loadu_si256(
+        (const __m256i *)(t_str + i + t_needle_size - 1));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first),
+                         _mm256_cmpeq_epi8(block_last, last)));
+    while (mask) {
+      size_t index = i + _rsv_ctz(mask);
+      if (memcmp(t_str + index + 1, t_needle + 1, t_needle_size - 2) == 0) {
+        *t_found = true;
+        return index;
+      }
+      mask &= mask - 1;
+    }
+  }
+  *t_found = false;
+  return i;
+}
+#endif // _RSV_AVX2
+
+#ifdef _RSV_SSE2
+/// @internal
+/// @brief Same as _rsv_find_avx2(), 16 positions at a time
+static inline size_t _rsv_find_sse2(const char *t_str, size_t t_size,
+                                    const char *t_needle, size_t t_needle_size,
+                                    size_t t_pos, bool *t_found) {
+  __m128i first = _mm_set1_epi8(t_needle[0]);
+  __m128i last = _mm_set1_epi8(t_needle[t_needle_size - 1]);
+  size_t i = t_pos;
+  for (; i + t_needle_size - 1 + 16 <= t_size; i += 16) {
+    __m128i block_first = _mm_loadu_si128((const __m128i *)(t_str + i));
+    __m128i block_last =
+        _mm_loadu_si128((const __m128i *)(t_str + i + t_needle_size - 1));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(
+        _mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+    while (mask) {
+      size_t index = i + _rsv_ctz(mask);
+      if (memcmp(t_str + index + 1, t_needle + 1, t_needle_size - 2) == 0) {
+        *t_found = true;
+        return index;
+      }
+      mask &= mask - 1;
+    }
+  }
+  *t_found = false;
+  return i;
+}
+#endif // _RSV_SSE2
+
+/// @brief Find the first occurrence of t_needle, starting at t_pos.
+/// @return The index of the first character of the match or RSV_NPOS
+static inline size_t rsv_find(rsv t_rsv, rsv t_needle, size_t t_pos) {
+  const char *str = t_rsv.m_str;
+  size_t size = rsv_size(t_rsv);
+  size_t needle_size = rsv_size(t_needle);
+  if (t_pos > size || needle_size > size - t_pos) {
+    return RSV_NPOS;
+  }
+  if (needle_size == 0) {
+    return t_pos;
+  }
+  if (needle_size == 1) {
+    return rsv_find_char(t_rsv, t_needle.m_str[0], t_pos);
+  }
+  size_t i = t_pos;
+  bool found = false;
+#ifdef _RSV_AVX2
+  if (_rsv_has_avx2()) {
+    i = _rsv_find_avx2(str, size, t_needle.m_str, needle_size, i, &found);
+  }
+#endif // _RSV_AVX2
+#ifdef _RSV_SSE2
+  if (!found) {
+    i = _rsv_find_sse2(str, size, t_needle.m_str, needle_size, i, &found);
+  }
+#endif // _RSV_SSE2
+  if (found) {
+    return i;
+  }
+  // The tail, or everything without SIMD
+  size_t last = size - needle_size;
+  while (i <= last) {
+    const char *first = (const char *)memchr(str + i, t_needle.m_str[0],
+                                             last - i + 1);
+    if (first == NULL) {
+      return RSV_NPOS;
+    }
+    i = (size_t)(first - str);
+    if (memcmp(str + i + 1, t_needle.m_str + 1, needle_size - 1) == 0) {
+      return i;
+    }
+    i++;
+  }
+  return RSV_NPOS;
+}
+
+/// @brief Find the last occurrence of t_needle starting at or before t_pos.
+/// @param t_pos RSV_NPOS to search the whole rsv
+/// @return The index of the first character of the match or RSV_NPOS
+static inline size_t rsv_rfind(rsv t_rsv, rsv t_needle, size_t t_pos) {
+  size_t size = rsv_size(t_rsv);
+  size_t needle_size = rsv_size(t_needle);
+  if (needle_size > size) {
+    return RSV_NPOS;
+  }
+  size_t i = t_pos < size - needle_size ? t_pos : size - needle_size;
+  if (needle_size == 0) {
+    return i;
+  }
+  char last = t_needle.m_str[needle_size - 1];
+  for (;;) {
+    // Look for the last character of the needle, it ends the match
+    i = rsv_rfind_char(t_rsv, last, i + needle_size - 1);
+    if (i == RSV_NPOS || i < needle_size - 1) {
+      return RSV_NPOS;
+    }
+    i -= needle_size - 1;
+    if (memcmp(t_rsv.m_str + i, t_needle.m_str, needle_size - 1) == 0) {
+      return i;
+    }
+    if (i == 0) {
+      return RSV_NPOS;
+    }
+    i--;
+  }
+}
+
+/// @brief Up to this many characters, rsv_find_first_of() compares every
+/// character of the set with SIMD, bigger sets use a lookup table
+#define RSV_SIMD_SET_MAX 4
+
+#ifdef _RSV_AVX2
+/// @internal
+__attribute__((target("avx2"))) static inline size_t
+_rsv_find_first_of_avx2(const char *t_str, size_t t_size, rsv t_set,
+                        size_t t_pos, bool *t_found) {
+  __m256i set[RSV_SIMD_SET_MAX];
+  for (size_t j = 0; j < rsv_size(t_set); j++) {
+    set[j] = _mm256_set1_epi8(t_set.m_str[j]);
+  }
+  size_t i = t_pos;
+  for (; i + 32 <= t_size; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i *)(t_str + i));
+    __m256i matches = _mm256_cmpeq_epi8(block, set[0]);
+    for (size_t j = 1; j < rsv_size(t_set); j++) {
+      matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, set[j]));
+    }
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(matches);
+    if (mask) {
+      *t_found = true;
+      return i + _rsv_ctz(mask);
+    }
+  }
+  *t_found = false;
+  return i;
+}
+#endif // _RSV_AVX2
+
+/// @brief Find the first character that is also in t_set, starting at t_pos.
+/// @return The index of the character or RSV_NPOS
+static inline size_t rsv_find_first_of(rsv t_rsv, rsv t_set, size_t t_pos) {
+  const char *str = t_rsv.m_str;
+  size_t size = rsv_size(t_rsv);
+  if (t_pos >= size || rsv_size(t_set) == 0) {
+    return RSV_NPOS;
+  }
+  if (rsv_size(t_set) == 1) {
+    return rsv_find_char(t_rsv, t_set.m_str[0], t_pos);
+  }
+  size_t i = t_pos;
+  if (rsv_size(t_set) <= RSV_SIMD_SET_MAX) {
+    bool found = false;
+#ifdef _RSV_AVX2
+    if (_rsv_has_avx2()) {
+      i = _rsv_find_first_of_avx2(str, size, t_set, i, &found);
+      if (found) {
+        return i;
+      }
+    }
+#endif // _RSV_AVX2
+#ifdef _RSV_SSE2
+    __m128i set[RSV_SIMD_SET_MAX];
+    for (size_t j = 0; j < rsv_size(t_set); j++) {
+      set[j] = _mm_set1_epi8(t_set.m_str[j]);
+    }
+    for (; i + 16 <= size; i += 16) {
+      __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+      __m128i matches = _mm_cmpeq_epi8(block, set[0]);
+      for (size_t j = 1; j < rsv_size(t_set); j++) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, set[j]));
+      }
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(matches);
+      if (mask) {
+        return i + _rsv_ctz(mask);
+      }
+    }
+#endif // _RSV_SSE2
+    (void)found;
+  }
+  // One bit per byte value
+  uint64_t table[4] = {0};
+  for (size_t j = 0; j < rsv_size(t_set); j++) {
+    unsigned char ch = (unsigned char)t_set.m_str[j];
+    table[ch >> 6] |= (uint64_t)1 << (ch & 63);
+  }
+  for (; i < size; i++) {
+    unsigned char ch = (unsigned char)str[i];
+    if (table[ch >> 6] >> (ch & 63) & 1) {
+      return i;
+    }
+  }
+  return RSV_NPOS;
+}
+
+/// @brief Check if two rsv hold the same characters.
+///
+/// The sizes are compared first, so views of different sizes never touch
+/// their characters.
+static inline bool rsv_eq(rsv t_rsv, rsv t_rsv_other) {
+  return rsv_size(t_rsv) == rsv_size(t_rsv_other) &&
+         (rsv_size(t_rsv) == 0 ||
+          memcmp(t_rsv.m_str, t_rsv_other.m_str, rsv_size(t_rsv)) == 0);
+}
+
+/// @brief Compare two rsv byte by byte, as unsigned characters.
+///
+/// A rsv that is a prefix of the other one is ordered first.
+/// @return A negative number, 0 or a positive number, like memcmp()
+static inline int rsv_cmp(rsv t_rsv, rsv t_rsv_other) {
+  size_t size = rsv_size(t_rsv) < rsv_size(t_rsv_other)
+                    ? rsv_size(t_rsv)
+                    : rsv_size(t_rsv_other);
+  int result = size ? memcmp(t_rsv.m_str, t_rsv_other.m_str, size) : 0;
+  if (result != 0) {
+    return result;
+  }
+  return (rsv_size(t_rsv) > rsv_size(t_rsv_other)) -
+         (rsv_size(t_rsv) < rsv_size(t_rsv_other));
+}
+
+/// @brief Check if a rsv begins with t_prefix.
+static inline bool rsv_starts_with(rsv t_rsv, rsv t_prefix) {
+  return rsv_size(t_prefix) <= rsv_size(t_rsv) &&
+         (rsv_size(t_prefix) == 0 ||
+          memcmp(t_rsv.m_str, t_prefix.m_str, rsv_size(t_prefix)) == 0);
+}
+
+/// @brief Check if a rsv ends with t_suffix.
+static inline bool rsv_ends_with(rsv t_rsv, rsv t_suffix) {
+  return rsv_size(t_suffix) <= rsv_size(t_rsv) &&
+         (rsv_size(t_suffix) == 0 ||
+          memcmp(t_rsv.m_str + rsv_size(t_rsv) - rsv_size(t_suffix),
+                 t_suffix.m_str, rsv_size(t_suffix)) == 0);
+}
+
+/// @brief Get t_count characters starting at t_index, clamped to the end of
+/// the rsv.
+/// @param t_count RSV_NPOS for everything after t_index
+static inline rsv rsv_substr(rsv t_rsv, size_t t_index, size_t t_count) {
+  if (t_index > rsv_size(t_rsv)) {
+    t_index = rsv_size(t_rsv);
+  }
+  size_t remaining = rsv_size(t_rsv) - t_index;
+  return (rsv){.m_size = t_count < remaining ? t_count : remaining,
+               .m_str = t_rsv.m_str + t_index};
+}
+
+/// @internal
+/// @brief Lower case of an ascii character, other bytes are left as they are
+static inline char _rsv_ascii_lower(char t_ch) {
+  return (unsigned char)(t_ch - 'A') < 26 ? (char)(t_ch | 0x20) : t_ch;
+}
+
+/// @internal
+/// @brief Upper case of an ascii character, other bytes are left as they are
+static inline char _rsv_ascii_upper(char t_ch) {
+  return (unsigned char)(t_ch - 'a') < 26 ? (char)(t_ch & ~0x20) : t_ch;
+}
+
+#ifdef _RSV_SSE2
+/// @internal
+/// @brief 0xff in every lane that holds a character from t_first to
+/// t_first + 25.
+///
+/// There is no unsigned byte compare, so the distance from t_first is moved
+/// into the signed range before comparing it.
+static inline __m128i _rsv_ascii_range_sse2(__m128i t_block, char t_first) {
+  __m128i dist = _mm_sub_epi8(t_block, _mm_set1_epi8(t_first));
+  dist = _mm_xor_si128(dist, _mm_set1_epi8((char)0x80));
+  return _mm_cmplt_epi8(dist, _mm_set1_epi8((char)(0x80 + 26)));
+}
+
+/// @internal
+static inline __m128i _rsv_ascii_lower_sse2(__m128i t_block) {
+  __m128i upper = _rsv_ascii_range_sse2(t_block, 'A');
+  return _mm_or_si128(t_block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif // _RSV_SSE2
+
+#ifdef _RSV_AVX2
+/// @internal
+/// @brief Same as _rsv_ascii_range_sse2(), 32 characters at a time
+__attribute__((target("avx2"))) static inline __m256i
+_rsv_ascii_range_avx2(__m256i t_block, char t_first) {
+  __m256i dist = _mm256_sub_epi8(t_block, _mm256_set1_epi8(t_first));
+  dist = _mm256_xor_si256(dist, _mm256_set1_epi8((char)0x80));
+  return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + 26)), dist);
+}
+
+/// @internal
+/// @brief Compare 32 characters at a time, ignoring ascii case
+/// @return How many characters were compared, or SIZE_MAX if they differ
+__attribute__((target("avx2"))) static inline size_t
+_rsv_eq_ignore_case_avx2(const char *t_str, const char *t_str_other,
+                         size_t t_size) {
+  size_t i = 0;
+  for (; i + 32 <= t_size; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i *)(t_str + i));
+    __m256i other = _mm256_loadu_si256((const __m256i *)(t_str_other + i));
+    __m256i bit = _mm256_set1_epi8(0x20);
+    block = _mm256_or_si256(
+        block, _mm256_and_si256(_rsv_ascii_range_avx2(block, 'A'), bit));
+    other = _mm256_or_si256(
+        other, _mm256_and_si256(_rsv_ascii_range_avx2(other, 'A'), bit));
+    if ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, other)) !=
+        UINT32_MAX) {
+      return SIZE_MAX;
+    }
+  }
+  return i;
+}
+#endif // _RSV_AVX2
+
+/// @brief Check if two rsv hold the same characters, treating ascii upper
+/// and lower case letters as equal.
+///
+/// Both sides are folded to lower case in registers, nothing is written.
+/// Bytes outside of ascii have to match exactly.
+static inline bool rsv_eq_ignore_case(rsv t_rsv, rsv t_rsv_other) {
+  size_t size = rsv_size(t_rsv);
+  if (size != rsv_size(t_rsv_other)) {
+    return false;
+  }
+  const char *str = t_rsv.m_str;
+  const char *other = t_rsv_other.m_str;
+  size_t i = 0;
+#ifdef _RSV_AVX2
+  if (size >= 32 && _rsv_has_avx2()) {
+    i = _rsv_eq_ignore_case_avx2(str, other, size);
+    if (i == SIZE_MAX) {
+      return false;
+    }
+  }
+#endif // _RSV_AVX2
+#ifdef _RSV_SSE2
+  for (; i + 16 <= size; i += 16) {
+    __m128i block = _rsv_ascii_lower_sse2(
+        _mm_loadu_si128((const __m128i *)(str + i)));
+    __m128i block_other = _rsv_ascii_lower_sse2(
+        _mm_loadu_si128((const __m128i *)(other + i)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, block_other)) != 0xffff) {
+      return false;
+    }
+  }
+#endif // _RSV_SSE2
+  for (; i < size; i++) {
+    if (_rsv_ascii_lower(str[i]) != _rsv_ascii_lower(other[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief Check if a rsv begins with t_prefix, ignoring ascii case.
+static inline bool rsv_starts_with_ignore_case(rsv t_rsv, rsv t_prefix) {
+  return rsv_size(t_prefix) <= rsv_size(t_rsv) &&
+         rsv_eq_ignore_case(rsv_substr(t_rsv, 0, rsv_size(t_prefix)),
+                            t_prefix);
+}
+
+/// @internal
+/// @brief Space, \t, \n, \v, \f and \r, what isspace() accepts in the C locale
+static inline bool _rsv_is_space(char t_ch) {
+  return t_ch == ' ' || (unsigned char)(t_ch - '\t') < 5;
+}
+
+#ifdef _RSV_SSE2
+/// @internal
+/// @brief One bit for every character of the block that is not white space
+static inline uint32_t _rsv_non_space_mask_sse2(const char *t_str) {
+  __m128i block = _mm_loadu_si128((const __m128i *)t_str);
+  // \t to \r are 5 characters in a row, the distance from \t is at most 4
+  __m128i dist = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+  __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(dist, _mm_set1_epi8(4)), dist);
+  __m128i space = _mm_or_si128(
+      control, _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')));
+  return ~(uint32_t)_mm_movemask_epi8(space) & 0xffff;
+}
+#endif // _RSV_SSE2
+
+/// @brief Remove the ascii white space at the beginning of a rsv.
+static inline rsv rsv_trim_left(rsv t_rsv) {
+  size_t size = rsv_size(t_rsv);
+  size_t i = 0;
+#ifdef _RSV_SSE2
+  for (; i + 16 <= size; i += 16) {
+    uint32_t mask = _rsv_non_space_mask_sse2(t_rsv.m_str + i);
+    if (mask) {
+      i += _rsv_ctz(mask);
+      return (rsv){.m_size = size - i, .m_str = t_rsv.m_str + i};
+    }
+  }
+#endif // _RSV_SSE2
+  while (i < size && _rsv_is_space(t_rsv.m_str[i])) {
+    i++;
+  }
+  return (rsv){.m_size = size - i, .m_str = t_rsv.m_str + i};
+}
+
+/// @brief Remove the ascii white space at the end of a rsv.
+static inline rsv rsv_trim_right(rsv t_rsv) {
+  // One past the last character that is kept
+  size_t end = rsv_size(t_rsv);
+#ifdef _RSV_SSE2
+  for (; end >= 16; end -= 16) {
+    uint32_t mask = _rsv_non_space_mask_sse2(t_rsv.m_str + end - 16);
+    if (mask) {
+      end = end - 16 + _rsv_clz_index(mask) + 1;
+      return (rsv){.m_size = end, .m_str = t_rsv.m_str};
+    }
+  }
+#endif // _RSV_SSE2
+  while (end > 0 && _rsv_is_space(t_rsv.m_str[end - 1])) {
+    end--;
+  }
+  return (rsv){.m_size = end, .m_str = t_rsv.m_str};
+}
+
+/// @brief Remove the ascii white space at both ends of a rsv.
+static inline rsv rsv_trim(rsv t_rsv) {
+  return rsv_trim_right(rsv_trim_left(t_rsv));
+}
+
+/// @internal
+enum _rsv_split_kind { _RSV_SPLIT_CHAR, _RSV_SPLIT_ANY, _RSV_SPLIT_STR };
+
+/// @brief Iterator over the pieces of a rsv between delimiters.
+///
+/// The pieces are rsvs pointing into the split rsv, nothing gets copied. Like
+/// with most split functions, n delimiters always give n + 1 pieces, so
+/// consecutive delimiters give empty pieces, skip them if they are not wanted.
+struct rsv_split {
+  rsv m_rsv;                   // Do not modify this, this is private
+  rsv m_delim;                 // Do not modify this, this is private
+  char m_ch;                   // Do not modify this, this is private
+  enum _rsv_split_kind m_kind; // Do not modify this, this is private
+  size_t m_pos;                // Do not modify this, this is private
+  bool m_done;                 // Do not modify this, this is private
+};
+
+/// @brief Split a rsv at every occurrence of a character.
+static inline struct rsv_split rsv_split_char(rsv t_rsv, char t_ch) {
+  return (struct rsv_split){
+      .m_rsv = t_rsv, .m_delim = RSV_NULL, .m_ch = t_ch,
+      .m_kind = _RSV_SPLIT_CHAR};
+}
+
+/// @brief Split a rsv at every character that is in t_set.
+static inline struct rsv_split rsv_split_any(rsv t_rsv, rsv t_set) {
+  return (struct rsv_split){
+      .m_rsv = t_rsv, .m_delim = t_set, .m_kind = _RSV_SPLIT_ANY};
+}
+
+/// @brief Split a rsv at every occurrence of t_delim.
+///
+/// An empty t_delim never matches, the rsv is not split at all.
+static inline struct rsv_split rsv_split(rsv t_rsv, rsv t_delim) {
+  return (struct rsv_split){
+      .m_rsv = t_rsv, .m_delim = t_delim, .m_kind = _RSV_SPLIT_STR};
+}
+
+/// @brief Get the next piece.
+/// @return false once all the pieces were returned
+static inline bool rsv_split_next(struct rsv_split *t_split, rsv *t_piece) {
+  if (t_split->m_done) {
+    return false;
+  }
+  size_t end = RSV_NPOS;
+  size_t delim_size = 1;
+  switch (t_split->m_kind) {
+  case _RSV_SPLIT_CHAR:
+    end = rsv_find_char(t_split->m_rsv, t_split->m_ch, t_split->m_pos);
+    break;
+  case _RSV_SPLIT_ANY:
+    end = rsv_find_first_of(t_split->m_rsv, t_split->m_delim, t_split->m_pos);
+    break;
+  case _RSV_SPLIT_STR:
+    delim_size = rsv_size(t_split->m_delim);
+    if (delim_size) {
+      end = rsv_find(t_split->m_rsv, t_split->m_delim, t_split->m_pos);
+    }
+    break;
+  }
+  if (end == RSV_NPOS) {
+    end = rsv_size(t_split->m_rsv);
+    t_split->m_done = true;
+  }
+  *t_piece = (rsv){.m_size = end - t_split->m_pos,
+                   .m_str = t_split->m_rsv.m_str + t_split->m_pos};
+  t_split->m_pos = end + delim_size;
+  return true;
+}
+
+/// @brief Push all the remaining pieces of a split into a rda of rsv.
+///
+/// Needs `rit_dyn_arr.h`. The pieces only stay valid as long as the split
+/// rsv does.
+/// @param t_split A `struct rsv_split *`
+/// @param t_rda An initialized rda created with `rda_struct(rsv)`
+#define rsv_split_collect(t_split, t_rda, t_allocator)                         \
+  do {                                                                         \
+    struct rsv_split *_split = (t_split);                                      \
+    if (_split->m_kind == _RSV_SPLIT_CHAR && !_split->m_done) {                \
+      /* Counting is much cheaper than growing the rda piece by piece */       \
+      rsv _rest = {.m_size = rsv_size(_split->m_rsv) - _split->m_pos,          \
+                   .m_str = _split->m_rsv.m_str + _split->m_pos};              \
+      rda_reserve((t_rda),                                                     \
+                  rda_size(t_rda) + rsv_count_char(_rest, _split->m_ch) + 2,   \
+                  (t_allocator));                                              \
+    }                                                                          \
+    rsv _piece;                                                                \
+    while (rsv_split_next(_split, &_piece)) {                                  \
+      rda_push_back((t_rda), _piece, (t_allocator));                           \
+    }                                                                          \
+  } while (0)
+
+// Eight digits at a time are only converted where the byte order is known
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define _RSV_SWAR
+#endif
+
+/// @internal
+static inline bool _rsv_is_digit(char t_ch) {
+  return (unsigned char)(t_ch - '0') < 10;
+}
+
+#ifdef _RSV_SWAR
+/// @internal
+static inline bool _rsv_is_8_digits(uint64_t t_chars) {
+  return ((t_chars & 0xF0F0F0F0F0F0F0F0) |
+          (((t_chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+/// @internal
+/// @brief Convert 8 ascii digits, read as a little endian integer, in a few
+/// multiplications instead of 8 dependent ones.
+static inline uint64_t _rsv_parse_8_digits(uint64_t t_chars) {
+  const uint64_t mask = 0x000000FF000000FF;
+  const uint64_t mul1 = 100 + (1000000ULL << 32);
+  const uint64_t mul2 = 1 + (10000ULL << 32);
+  t_chars -= 0x3030303030303030;
+  // Combine pairs of digits, then pairs of pairs, then the two halves
+  t_chars = (t_chars * 10) + (t_chars >> 8);
+  return (((t_chars & mask) * mul1) + (((t_chars >> 16) & mask) * mul2)) >>
+         32;
+}
+#endif // _RSV_SWAR
+
+/// @internal
+/// @brief Append up to t_max digits starting at t_pos to *t_val.
+/// @return The index after the last digit read
+static inline size_t _rsv_read_digits(const char *t_str, size_t t_size,
+                                      size_t t_pos, uint64_t *t_val,
+                                      size_t t_max) {
+  size_t limit = t_size - t_pos < t_max ? t_size : t_pos + t_max;
+  uint64_t val = *t_val;
+#ifdef _RSV_SWAR
+  while (limit - t_pos >= 8) {
+    uint64_t chars;
+    memcpy(&chars, t_str + t_pos, 8);
+    if (!_rsv_is_8_digits(chars)) {
+      break;
+    }
+    val = val * 100000000 + _rsv_parse_8_digits(chars);
+    t_pos += 8;
+  }
+#endif // _RSV_SWAR
+  for (; t_pos < limit && _rsv_is_digit(t_str[t_pos]); t_pos++) {
+    val = val * 10 + (uint64_t)(t_str[t_pos] - '0');
+  }
+  *t_val = val;
+  return t_pos;
+}
+
+/// @brief Parse an unsigned decimal integer from the start of a rsv.
+///
+/// Unlike strtoull(), no whitespace or sign is accepted and the rsv doesn't
+/// need to be null terminated.
+/// @return The number of characters parsed, 0 if the rsv doesn't start with a
+/// digit or the number doesn't fit in 64 bits, then *t_val is not changed
+static inline size_t rsv_parse_u64(rsv t_rsv, uint64_t *t_val) {
+  const char *str = t_rsv.m_str;
+  size_t size = rsv_size(t_rsv);
+  size_t pos = 0;
+  while (pos < size && str[pos] == '0') {
+    pos++;
+  }
+  bool has_zeros = pos > 0;
+  uint64_t val = 0;
+  // 19 digits always fit, the 20th needs a check
+  size_t end = _rsv_read_digits(str, size, pos, &val, 19);
+  if (end == pos && !has_zeros) {
+    return 0;
+  }
+  if (end < size && _rsv_is_digit(str[end])) {
+    uint64_t digit = (uint64_t)(str[end] - '0');
+    if (val > (UINT64_MAX - digit) / 10) {
+      return 0;
+    }
+    val = val * 10 + digit;
+    end++;
+    if (end < size && _rsv_is_digit(str[end])) {
+      return 0;
+    }
+  }
+  *t_val = val;
+  return end;
+}
+
+/// @brief Parse a signed decimal integer from the start of a rsv.
+///
+/// An optional '+' or '-' may come before the digits.
+/// @return The number of characters parsed, 0 if there is no number or it
+/// doesn't fit in 64 bits, then *t_val is not changed
+static inline size_t rsv_parse_i64(rsv t_rsv, int64_t *t_val) {
+  size_t pos = 0;
+  bool negative = false;
+  if (rsv_size(t_rsv) && (t_rsv.m_str[0] == '-' || t_rsv.m_str[0] == '+')) {
+    negative = t_rsv.m_str[0] == '-';
+    pos++;
+  }
+  uint64_t magnitude;
+  size_t parsed = rsv_parse_u64(
+      (rsv){.m_size = rsv_size(t_rsv) - pos, .m_str = t_rsv.m_str + pos},
+      &magnitude);
+  if (parsed == 0 || magnitude > (uint64_t)INT64_MAX + negative) {
+    return 0;
+  }
+  *t_val = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+  return pos + parsed;
+}
+
+/// @internal
+/// @brief Check for a lower case word, ignoring the case of the rsv
+static inline bool _rsv_match_word(const char *t_str, size_t t_size,
+                                   size_t t_pos, const char *t_word,
+                                   size_t t_word_size) {
+  if (t_size - t_pos < t_word_size) {
+    return false;
+  }
+  for (size_t i = 0; i < t_word_size; i++) {
+    if ((t_str[t_pos + i] | 0x20) != t_word[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief Significant digits kept when a float is handed to strtod(), enough
+/// to round any double correctly
+#define _RSV_F64_DIGITS 800
+
+/// @internal
+/// @brief Convert a float strtod() style, the digits are normalized first so
+/// the locale's decimal point doesn't matter.
+RSTR_INTERNAL_DEF inline double _rsv_parse_f64_slow(const char *t_str,
+                                                    size_t t_begin,
+                                                    size_t t_end,
+                                                    int64_t t_exp10) {
+  char buf[_RSV_F64_DIGITS + 32];
+  size_t digit_count = 0;
+  // Position of the decimal point relative to the first significant digit
+  int64_t point = 0;
+  bool seen_point = false;
+  bool seen_nonzero = false;
+  bool sticky = false;
+  for (size_t i = t_begin; i < t_end; i++) {
+    char ch = t_str[i];
+    if (ch == '.') {
+      seen_point = true;
+      continue;
+    }
+    if (!seen_nonzero && ch == '0') {
+      point -= seen_point;
+      continue;
+    }
+    seen_nonzero = true;
+    point += !seen_point;
+    if (digit_count < _RSV_F64_DIGITS) {
+      buf[digit_count++] = ch;
+    } else if (ch != '0') {
+      // Any nonzero digit that got cut still decides how a tie rounds
+      sticky = true;
+    }
+  }
+  if (sticky) {
+    buf[digit_count++] = '1';
+  }
+  int64_t exp10 = t_exp10 + point - (int64_t)digit_count;
+  // Far beyond the range of a double, the result is 0 or inf either way
+  exp10 = exp10 < -100000 ? -100000 : exp10 > 100000 ? 100000 : exp10;
+  snprintf(buf + digit_count, sizeof(buf) - digit_count, "e%lld",
+           (long long)exp10);
+  return strtod(buf, NULL);
+}
+
+/// @brief Parse a decimal floating point number from the start of a rsv.
+///
+/// Accepts the same decimal syntax as strtod(): an optional sign, digits with
+/// an optional '.', an optional exponent, or inf, infinity and nan in any
+/// case. Hexadecimal floats and whitespace are not accepted, and '.' is the
+/// decimal point whatever the locale is. Numbers with up to 19 significant
+/// digits, a mantissa below 2^53 and a decimal exponent within 22 are
+/// converted with one exact multiplication or division, which is correctly
+/// rounded. Everything else is normalized and handed to strtod().
+/// @return The number of characters parsed, 0 if the rsv doesn't start with a
+/// number, then *t_val is not changed
+static inline size_t rsv_parse_f64(rsv t_rsv, double *t_val) {
+  static const double powers_of_10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char *str = t_rsv.m_str;
+  size_t size = rsv_size(t_rsv);
+  size_t pos = 0;
+  bool negative = false;
+  if (pos < size && (str[pos] == '-' || str[pos] == '+')) {
+    negative = str[pos] == '-';
+    pos++;
+  }
+
+  if (_rsv_match_word(str, size, pos, "inf", 3)) {
+    *t_val = negative ? -HUGE_VAL : HUGE_VAL;
+    return _rsv_match_word(str, size, pos, "infinity", 8) ? pos + 8 : pos + 3;
+  }
+  if (_rsv_match_word(str, size, pos, "nan", 3)) {
+    *t_val = negative ? -NAN : NAN;
+    return pos + 3;
+  }
+
+  // The first 19 significant digits go into the mantissa, the rest are only
+  // counted
+  size_t digits_begin = pos;
+  uint64_t mantissa = 0;
+  size_t significant = 0;
+  int64_t exp10 = 0;
+  while (pos < size && str[pos] == '0') {
+    pos++;
+  }
+  size_t begin = pos;
+  pos = _rsv_read_digits(str, size, pos, &mantissa, 19);
+  significant = pos - begin;
+  begin = pos;
+  while (pos < size && _rsv_is_digit(str[pos])) {
+    pos++;
+  }
+  exp10 += (int64_t)(pos - begin);
+  significant += pos - begin;
+  bool has_digits = pos > digits_begin;
+
+  if (pos < size && str[pos] == '.') {
+    pos++;
+    size_t fraction_begin = pos;
+    if (significant == 0) {
+      while (pos < size && str[pos] == '0') {
+        pos++;
+      }
+      exp10 -= (int64_t)(pos - fraction_begin);
+    }
+    begin = pos;
+    pos = _rsv_read_digits(str, size, pos, &mantissa,
+                           significant < 19 ? 19 - significant : 0);
+    exp10 -= (int64_t)(pos - begin);
+    significant += pos - begin;
+    begin = pos;
+    while (pos < size && _rsv_is_digit(str[pos])) {
+      pos++;
+    }
+    significant += pos - begin;
+    has_digits = has_digits || pos > fraction_begin;
+  }
+  if (!has_digits) {
+    return 0;
+  }
+  size_t digits_end = pos;
+
+  // The exponent is only part of the number if it has digits
+  int64_t exponent = 0;
+  if (pos < size && (str[pos] == 'e' || str[pos] == 'E')) {
+    size_t exponent_pos = pos + 1;
+    bool exponent_negative = false;
+    if (exponent_pos < size &&
+        (str[exponent_pos] == '-' || str[exponent_pos] == '+')) {
+      exponent_negative = str[exponent_pos] == '-';
+      exponent_pos++;
+    }
+    if (exponent_pos < size && _rsv_is_digit(str[exponent_pos])) {
+      for (; exponent_pos < size && _rsv_is_digit(str[exponent_pos]);
+           exponent_pos++) {
+        if (exponent < 100000) {
+          exponent = exponent * 10 + (str[exponent_pos] - '0');
+        }
+      }
+      exponent = exponent_negative ? -exponent : exponent;
+      pos = exponent_pos;
+    }
+  }
+  exp10 += exponent;
+
+  double val;
+  if (mantissa == 0) {
+    val = 0.0;
+  } else if (significant <= 19 && mantissa <= (uint64_t)1 << 53 &&
+             exp10 >= -22 && exp10 <= 22) {
+    // Both the mantissa and the power of 10 are exact, so the one rounding
+    // done by the multiplication or division is the correct one
+    val = exp10 < 0 ? (double)mantissa / powers_of_10[-exp10]
+                    : (double)mantissa * powers_of_10[exp10];
+  } else {
+    val = _rsv_parse_f64_slow(str, digits_begin, digits_end, exponent);
+  }
+  *t_val = negative ? -val : val;
+  return pos;
+}
+
+/// @internal
+/// @brief 64 x 64 bit multiplication, the low half goes to *t_a and the high
+/// half to *t_b
+static inline void _rsv_mul128(uint64_t *t_a, uint64_t *t_b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = (__uint128_t)*t_a * *t_b;
+  *t_a = (uint64_t)product;
+  *t_b = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  *t_a = _umul128(*t_a, *t_b, t_b);
+#else
+  uint64_t a_high = *t_a >> 32, a_low = (uint32_t)*t_a;
+  uint64_t b_high = *t_b >> 32, b_low = (uint32_t)*t_b;
+  uint64_t high_high = a_high * b_high, high_low = a_high * b_low;
+  uint64_t low_high = a_low * b_high, low_low = a_low * b_low;
+  uint64_t middle = (low_low >> 32) + (uint32_t)high_low + (uint32_t)low_high;
+  *t_a = (middle << 32) | (uint32_t)low_low;
+  *t_b = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+#endif
+}
+
+/// @internal
+static inline uint64_t _rsv_mix(uint64_t t_a, uint64_t t_b) {
+  _rsv_mul128(&t_a, &t_b);
+  return t_a ^ t_b;
+}
+
+/// @internal
+/// @brief Little endian loads, so the hash is the same on every platform
+static inline uint64_t _rsv_read64(const uint8_t *t_ptr) {
+  uint64_t val;
+  memcpy(&val, t_ptr, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  val = __builtin_bswap64(val);
+#endif
+  return val;
+}
+
+/// @internal
+static inline uint64_t _rsv_read32(const uint8_t *t_ptr) {
+  uint32_t val;
+  memcpy(&val, t_ptr, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  val = __builtin_bswap32(val);
+#endif
+  return val;
+}
+
+/// @brief Hash a rsv with a seed.
+///
+/// This is wyhash: the input is folded into the state with 64 x 64 -> 128 bit
+/// multiplications, 48 bytes per round in three independent lanes on long
+/// inputs, so it runs at memory speed without needing SIMD. It is not a
+/// cryptographic hash, but with a random secret seed the hashes can't be
+/// predicted, which protects hash tables against crafted collisions.
+static inline uint64_t rsv_hash_seeded(rsv t_rsv, uint64_t t_seed) {
+  static const uint64_t secret[4] = {0x2d358dccaa6c78a5, 0x8bb84b93962eacc9,
+                                     0x4b33a62ed433d4a3, 0x4d5a2da51de1aa47};
+  const uint8_t *ptr = (const uint8_t *)t_rsv.m_str;
+  size_t size = rsv_size(t_rsv);
+  uint64_t seed = t_seed ^ _rsv_mix(t_seed ^ secret[0], secret[1]);
+  uint64_t a, b;
+  if (size <= 16) {
+    if (size >= 4) {
+      // Two overlapping pairs of 4 byte reads cover 4 to 16 bytes
+      size_t offset = (size >> 3) << 2;
+      a = (_rsv_read32(ptr) << 32) | _rsv_read32(ptr + offset);
+      b = (_rsv_read32(ptr + size - 4) << 32) |
+          _rsv_read32(ptr + size - 4 - offset);
+    } else if (size > 0) {
+      a = ((uint64_t)ptr[0] << 16) | ((uint64_t)ptr[size >> 1] << 8) |
+          ptr[size - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t remaining = size;
+    if (remaining >= 48) {
+      uint64_t seed1 = seed, seed2 = seed;
+      do {
+        seed = _rsv_mix(_rsv_read64(ptr) ^ secret[1],
+                        _rsv_read64(ptr + 8) ^ seed);
+        seed1 = _rsv_mix(_rsv_read64(ptr + 16) ^ secret[2],
+                         _rsv_read64(ptr + 24) ^ seed1);
+        seed2 = _rsv_mix(_rsv_read64(ptr + 32) ^ secret[3],
+                         _rsv_read64(ptr + 40) ^ seed2);
+        ptr += 48;
+        remaining -= 48;
+      } while (remaining >= 48);
+      seed ^= seed1 ^ seed2;
+    }
+    while (remaining > 16) {
+      seed =
+          _rsv_mix(_rsv_read64(ptr) ^ secret[1], _rsv_read64(ptr + 8) ^ seed);
+      ptr += 16;
+      remaining -= 16;
+    }
+    // The last 16 bytes, overlapping what was already hashed
+    a = _rsv_read64(ptr + remaining - 16);
+    b = _rsv_read64(ptr + remaining - 8);
+  }
+  a ^= secret[1];
+  b ^= seed;
+  _rsv_mul128(&a, &b);
+  return _rsv_mix(a ^ secret[0] ^ size, b ^ secret[1]);
+}
+
+/// @brief Hash a rsv, same as `rsv_hash_seeded()` with a seed of 0.
+static inline uint64_t rsv_hash(rsv t_rsv) {
+  return rsv_hash_seeded(t_rsv, 0);
+}
+
+/// @internal
+/// @brief Length of the sequence a byte starts, 1 for ASCII and invalid
+/// bytes
+static inline size_t _rsv_utf8_length(unsigned char t_lead) {
+  return t_lead >= 0xF0 ? 4 : t_lead >= 0xE0 ? 3 : t_lead >= 0xC0 ? 2 : 1;
+}
+
+/// @internal
+/// @brief Decode one code point, following the well formed byte sequences of
+/// the Unicode standard: no overlong forms, surrogates or values past
+/// U+10FFFF.
+/// @return The length of the sequence, 0 if it is not valid
+static inline size_t _rsv_utf8_decode(const unsigned char *t_str, size_t t_size,
+                                      uint32_t *t_code_point) {
+  unsigned char lead = t_str[0];
+  if (lead < 0x80) {
+    *t_code_point = lead;
+    return 1;
+  }
+  // The second byte has a narrower range after some lead bytes
+  unsigned char low = 0x80, high = 0xBF;
+  size_t length;
+  uint32_t code_point;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    length = 2;
+    code_point = lead & 0x1F;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+    code_point = lead & 0x0F;
+    low = lead == 0xE0 ? 0xA0 : low;
+    high = lead == 0xED ? 0x9F : high;
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    length = 4;
+    code_point = lead & 0x07;
+    low = lead == 0xF0 ? 0x90 : low;
+    high = lead == 0xF4 ? 0x8F : high;
+  } else {
+    return 0;
+  }
+  if (t_size < length || t_str[1] < low || t_str[1] > high) {
+    return 0;
+  }
+  for (size_t i = 1; i < length; i++) {
+    if ((t_str[i] & 0xC0) != 0x80) {
+      return 0;
+    }
+    code_point = (code_point << 6) | (t_str[i] & 0x3F);
+  }
+  *t_code_point = code_point;
+  return length;
+}
+
+/// @internal
+static inline bool _rsv_utf8_validate_scalar(const unsigned char *t_str,
+                                             size_t t_size) {
+  size_t i = 0;
+  while (i < t_size) {
+    if (t_size - i >= 8) {
+      uint64_t chars;
+      memcpy(&chars, t_str + i, 8);
+      if ((chars & 0x8080808080808080) == 0) {
+        i += 8;
+        continue;
+      }
+    }
+    uint32_t code_point;
+    size_t length = _rsv_utf8_decode(t_str + i, t_size - i, &code_point);
+    if (length == 0) {
+      return false;
+    }
+    i += length;
+  }
+  return true;
+}
+
+#ifdef _RSV_AVX2
+/// @internal
+/// @brief The same 16 entry table in both lanes, for _mm256_shuffle_epi8()
+#define _RSV_UTF8_TABLE(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+
+// Error classes of a pair of bytes, a pair is invalid if the classes of the
+// high nibble of its first byte, the low nibble of its first byte and the
+// high nibble of its second byte have a bit in common
+#define _RSV_UTF8_TOO_SHORT (1 << 0)  // Lead not followed by a continuation
+#define _RSV_UTF8_TOO_LONG (1 << 1)   // ASCII followed by a continuation
+#define _RSV_UTF8_OVERLONG_3 (1 << 2) // 11100000 100xxxxx
+#define _RSV_UTF8_TOO_LARGE (1 << 3)  // 11110100 1001xxxx or 11110101+
+#define _RSV_UTF8_SURROGATE (1 << 4)  // 11101101 101xxxxx
+#define _RSV_UTF8_OVERLONG_2 (1 << 5) // 1100000x 10xxxxxx
+#define _RSV_UTF8_TOO_LARGE_1000 (1 << 6)
+#define _RSV_UTF8_OVERLONG_4 (1 << 6) // 11110000 1000xxxx
+#define _RSV_UTF8_TWO_CONTS (1 << 7)  // Continuation following continuation
+#define _RSV_UTF8_CARRY                                                        \
+  (_RSV_UTF8_TOO_SHORT | _RSV_UTF8_TOO_LONG | _RSV_UTF8_TWO_CONTS)
+
+/// @internal
+/// @brief Classify every pair of adjacent bytes with three table lookups, then
+/// check that the third and fourth bytes of long sequences are continuations.
+/// @return Nonzero bytes where the input is not valid
+__attribute__((target("avx2"))) static inline __m256i
+_rsv_utf8_check_avx2(__m256i t_input, __m256i t_prev_input) {
+  const __m256i byte_1_high_table = _RSV_UTF8_TABLE(
+      _RSV_UTF8_TOO_LONG, _RSV_UTF8_TOO_LONG, _RSV_UTF8_TOO_LONG,
+      _RSV_UTF8_TOO_LONG, _RSV_UTF8_TOO_LONG, _RSV_UTF8_TOO_LONG,
+      _RSV_UTF8_TOO_LONG, _RSV_UTF8_TOO_LONG, _RSV_UTF8_TWO_CONTS,
+      _RSV_UTF8_TWO_CONTS, _RSV_UTF8_TWO_CONTS, _RSV_UTF8_TWO_CONTS,
+      _RSV_UTF8_TOO_SHORT | _RSV_UTF8_OVERLONG_2, _RSV_UTF8_TOO_SHORT,
+      _RSV_UTF8_TOO_SHORT | _RSV_UTF8_OVERLONG_3 | _RSV_UTF8_SURROGATE,
+      _RSV_UTF8_TOO_SHORT | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000 |
+          _RSV_UTF8_OVERLONG_4);
+  const __m256i byte_1_low_table = _RSV_UTF8_TABLE(
+      _RSV_UTF8_CARRY | _RSV_UTF8_OVERLONG_3 | _RSV_UTF8_OVERLONG_2 |
+          _RSV_UTF8_OVERLONG_4,
+      _RSV_UTF8_CARRY | _RSV_UTF8_OVERLONG_2, _RSV_UTF8_CARRY, _RSV_UTF8_CARRY,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000 |
+          _RSV_UTF8_SURROGATE,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000,
+      _RSV_UTF8_CARRY | _RSV_UTF8_TOO_LARGE | _RSV_UTF8_TOO_LARGE_1000);
+  const __m256i byte_2_high_table = _RSV_UTF8_TABLE(
+      _RSV_UTF8_TOO_SHORT, _RSV_UTF8_TOO_SHORT, _RSV_UTF8_TOO_SHORT,
+      _RSV_UTF8_TOO_SHORT, _RSV_UTF8_TOO_SHORT, _RSV_UTF8_TOO_SHORT,
+      _RSV_UTF8_TOO_SHORT, _RSV_UTF8_TOO_SHORT,
+      _RSV_UTF8_TOO_LONG | _RSV_UTF8_OVERLONG_2 | _RSV_UTF8_TWO_CONTS |
+          _RSV_UTF8_OVERLONG_3 | _RSV_UTF8_TOO_LARGE_1000 |
+          _RSV_UTF8_OVERLONG_4,
+      _RSV_UTF8_TOO_LONG | _RSV_UTF8_OVERLONG_2 | _RSV_UTF8_TWO_CONTS |
+          _RSV_UTF8_OVERLONG_3 | _RSV_UTF8_TOO_LARGE,
+      _RSV_UTF8_TOO_LONG | _RSV_UTF8_OVERLONG_2 | _RSV_UTF8_TWO_CONTS |
+          _RSV_UTF8_SURROGATE | _RSV_UTF8_TOO_LARGE,
+      _RSV_UTF8_TOO_LONG | _RSV_UTF8_OVERLONG_2 | _RSV_UTF8_TWO_CONTS |
+          _RSV_UTF8_SURROGATE | _RSV_UTF8_TOO_LARGE,
+      _RSV_UTF8_TOO_SHORT, _RSV_UTF8_TOO_SHORT, _RSV_UTF8_TOO_SHORT,
+      _RSV_UTF8_TOO_SHORT);
+  const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+  // The input shifted right by 1, 2 and 3 bytes, continuing from the previous
+  // block
+  __m256i prev_shifted = _mm256_permute2x128_si256(t_prev_input, t_input, 0x21);
+  __m256i prev1 = _mm256_alignr_epi8(t_input, prev_shifted, 15);
+  __m256i prev2 = _mm256_alignr_epi8(t_input, prev_shifted, 14);
+  __m256i prev3 = _mm256_alignr_epi8(t_input, prev_shifted, 13);
+  __m256i byte_1_high = _mm256_shuffle_epi8(
+      byte_1_high_table,
+      _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+  __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table,
+                                           _mm256_and_si256(prev1, low_nibble));
+  __m256i byte_2_high = _mm256_shuffle_epi8(
+      byte_2_high_table,
+      _mm256_and_si256(_mm256_srli_epi16(t_input, 4), low_nibble));
+  __m256i special_cases =
+      _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+  // Bytes 2 or 3 positions after a 3 or 4 byte lead must be continuations,
+  // the pair check above marks exactly those continuations with TWO_CONTS
+  __m256i third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80));
+  __m256i fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80));
+  __m256i must_be_continuation = _mm256_and_si256(
+      _mm256_or_si256(third_byte, fourth_byte), _mm256_set1_epi8((char)0x80));
+  return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+/// @internal
+__attribute__((target("avx2"))) static inline bool
+_rsv_utf8_validate_avx2(const unsigned char *t_str, size_t t_size) {
+  // Nonzero where the last bytes of a block start a sequence that needs more
+  // bytes than are left in the block
+  const __m256i incomplete_limit = _mm256_setr_epi8(
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1),
+      (char)(0xE0 - 1), (char)(0xC0 - 1));
+  __m256i prev_input = _mm256_setzero_si256();
+  __m256i prev_incomplete = _mm256_setzero_si256();
+  __m256i error = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= t_size; i += 32) {
+    __m256i input = _mm256_loadu_si256((const __m256i *)(t_str + i));
+    if (_mm256_movemask_epi8(input) == 0) {
+      // All ASCII, only a sequence left open by the last block is an error
+      error = _mm256_or_si256(error, prev_incomplete);
+    } else {
+      error = _mm256_or_si256(error, _rsv_utf8_check_avx2(input, prev_input));
+      prev_incomplete = _mm256_subs_epu8(input, incomplete_limit);
+    }
+    prev_input = input;
+  }
+  if (i < t_size) {
+    // The tail padded with zeros, which cut any unfinished sequence short
+    unsigned char tail[32] = {0};
+    memcpy(tail, t_str + i, t_size - i);
+    __m256i input = _mm256_loadu_si256((const __m256i *)tail);
+    error = _mm256_or_si256(error, _rsv_utf8_check_avx2(input, prev_input));
+  } else {
+    error = _mm256_or_si256(error, prev_incomplete);
+  }
+  return _mm256_testz_si256(error, error);
+}
+#endif // _RSV_AVX2
+
+/// @brief Check that a rsv holds valid UTF-8.
+///
+/// With AVX2, 32 bytes are checked at once with the lookup table algorithm of
+/// Keiser and Lemire, and blocks of ASCII only need one comparison. Otherwise
+/// runs of ASCII are skipped 8 bytes at a time and the rest is decoded.
+static inline bool rsv_utf8_validate(rsv t_rsv) {
+  const unsigned char *str = (const unsigned char *)t_rsv.m_str;
+#ifdef _RSV_AVX2
+  if (_rsv_has_avx2()) {
+    return _rsv_utf8_validate_avx2(str, rsv_size(t_rsv));
+  }
+#endif // _RSV_AVX2
+  return _rsv_utf8_validate_scalar(str, rsv_size(t_rsv));
+}
+
+/// @brief Count the code points of valid UTF-8, which are all the bytes that
+/// are not continuation bytes.
+static inline size_t rsv_utf8_count(rsv t_rsv) {
+  const char *str = t_rsv.m_str;
+  size_t size = rsv_size(t_rsv);
+  size_t count = 0;
+  size_t i = 0;
+#ifdef _RSV_SSE2
+  // Continuation bytes are 10xxxxxx, which is below -64 as a signed byte
+  __m128i limit = _mm_set1_epi8(-65);
+  while (i + 16 <= size) {
+    __m128i counts = _mm_setzero_si128();
+    for (size_t round = 0; round < 255 && i + 16 <= size; round++, i += 16) {
+      __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+      counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(block, limit));
+    }
+    __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+    count += (size_t)_mm_cvtsi128_si32(sums) +
+             (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+  }
+#endif // _RSV_SSE2
+  for (; i < size; i++) {
+    count += (signed char)str[i] > -65;
+  }
+  return count;
+}
+
+/// @brief Decoder of the code points of a rsv
+struct rsv_utf8_iter {
+  rsv m_rsv;    // Do not modify this, this is private
+  size_t m_pos; // Do not modify this, this is private
+};
+
+static inline struct rsv_utf8_iter rsv_utf8_iter(rsv t_rsv) {
+  return (struct rsv_utf8_iter){.m_rsv = t_rsv};
+}
+
+/// @brief Get the next code point.
+///
+/// A byte that doesn't start a valid sequence gives U+FFFD, the replacement
+/// character, and decoding continues with the next byte.
+/// @return false at the end of the rsv
+static inline bool rsv_utf8_next(struct rsv_utf8_iter *t_iter,
+                                 uint32_t *t_code_point) {
+  if (t_iter->m_pos >= rsv_size(t_iter->m_rsv)) {
+    return false;
+  }
+  size_t length = _rsv_utf8_decode(
+      (const unsigned char *)t_iter->m_rsv.m_str + t_iter->m_pos,
+      rsv_size(t_iter->m_rsv) - t_iter->m_pos, t_code_point);
+  if (length == 0) {
+    *t_code_point = 0xFFFD;
+    length = 1;
+  }
+  t_iter->m_pos += length;
+  return true;
+}
+
+/// @brief Validates UTF-8 that arrives in chunks, split anywhere.
+///
+/// A zero initialized stream is ready to use. A sequence cut by the end of a
+/// chunk is kept until the next chunk completes it.
+struct rsv_utf8_stream {
+  unsigned char m_carry[4]; // Do not modify this, this is private
+  size_t m_carry_size;      // Do not modify this, this is private
+  bool m_error;             // Do not modify this, this is private
+};
+
+/// @brief Validate the next chunk of a stream.
+static inline void rsv_utf8_stream_feed(struct rsv_utf8_stream *t_stream,
+                                        rsv t_chunk) {
+  const unsigned char *str = (const unsigned char *)t_chunk.m_str;
+  size_t size = rsv_size(t_chunk);
+  if (t_stream->m_error) {
+    return;
+  }
+  if (t_stream->m_carry_size) {
+    size_t length = _rsv_utf8_length(t_stream->m_carry[0]);
+    size_t missing = length - t_stream->m_carry_size;
+    missing = missing < size ? missing : size;
+    memcpy(t_stream->m_carry + t_stream->m_carry_size, str, missing);
+    t_stream->m_carry_size += missing;
+    str += missing;
+    size -= missing;
+    if (t_stream->m_carry_size < length) {
+      return;
+    }
+    t_stream->m_carry_size = 0;
+    if (!_rsv_utf8_validate_scalar(t_stream->m_carry, length)) {
+      t_stream->m_error = true;
+      return;
+    }
+  }
+  // Leave out a sequence that the chunk ends in the middle of
+  size_t complete = size;
+  for (size_t back = 1; back <= 3 && back <= size; back++) {
+    unsigned char ch = str[size - back];
+    if ((ch & 0xC0) != 0x80) {
+      complete = _rsv_utf8_length(ch) > back ? size - back : size;
+      break;
+    }
+  }
+  if (!rsv_utf8_validate(
+          (rsv){.m_size = complete, .m_str = (const char *)str})) {
+    t_stream->m_error = true;
+    return;
+  }
+  memcpy(t_stream->m_carry, str + complete, size - complete);
+  t_stream->m_carry_size = size - complete;
+}
+
+/// @brief Check a stream after its last chunk.
+/// @return true if all the chunks together are valid UTF-8
+static inline bool rsv_utf8_stream_valid(struct rsv_utf8_stream *t_stream) {
+  return !t_stream->m_error && t_stream->m_carry_size == 0;
 }
 
 /// @internal
 RSTR_INTERNAL_DEF inline void
 _rstr_init_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
                          size_t t_size, rstr_allocator *t_allocator) {
+  if (t_size <= RSTR_SSO_CAP) {
+    *t_rstr = (struct rstr){};
+    t_rstr->m_inline[_RSTR_TAG] = (char)t_size;
+    return;
+  }
   size_t capacity = DEFAULT_STR_CAP < t_size * 2 ? t_size * 2 : DEFAULT_STR_CAP;
-  t_rstr->m_data = (char *)t_allocator->alloc(t_allocator->m_ctx, capacity);
-  if (!t_rstr->m_data) {
+  t_rstr->m_heap.m_data =
+      (char *)t_allocator->alloc(t_allocator->m_ctx, capacity);
+  if (!t_rstr->m_heap.m_data) {
     fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
             t_line);
     exit(EXIT_FAILURE);
   }
-  t_rstr->m_size = t_size;
-  t_rstr->m_capacity = capacity;
+  t_rstr->m_heap.m_size = t_size;
+  t_rstr->m_heap.m_capacity = _RSTR_CAP_ENCODE(capacity);
+  _rstr_hash_reset(t_rstr);
 }
 
 #define rstr_init(t_rstr, t_size, t_allocator)                                 \
@@ -150,17 +1709,34 @@ RSTR_INTERNAL_DEF inline void _rstr_realloc(const char *t_file, int t_line,
                                             struct rstr *t_rstr,
                                             size_t t_new_capacity,
                                             rstr_allocator *t_allocator) {
-  if (t_new_capacity > rstr_capacity(t_rstr)) {
-    t_rstr->m_data =
-        (char *)t_allocator->realloc(t_allocator->m_ctx, t_rstr->m_data,
-                                     rstr_capacity(t_rstr), t_new_capacity);
-    if (!t_rstr->m_data) {
-      fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n",
-              t_file, t_line);
+  if (t_new_capacity <= rstr_capacity(t_rstr)) {
+    return;
+  }
+  if (!_rstr_is_heap(t_rstr)) {
+    // Move the inline characters to the heap
+    size_t size = rstr_size(t_rstr);
+    char *data = (char *)t_allocator->alloc(t_allocator->m_ctx, t_new_capacity);
+    if (!data) {
+      fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+              t_line);
       exit(EXIT_FAILURE);
     }
-    t_rstr->m_capacity = t_new_capacity;
+    memcpy(data, t_rstr->m_inline, size);
+    data[size] = '\0';
+    t_rstr->m_heap.m_data = data;
+    t_rstr->m_heap.m_size = size;
+    t_rstr->m_heap.m_capacity = _RSTR_CAP_ENCODE(t_new_capacity);
+    return;
   }
+  t_rstr->m_heap.m_data = (char *)t_allocator->realloc(
+      t_allocator->m_ctx, t_rstr->m_heap.m_data, rstr_capacity(t_rstr),
+      t_new_capacity);
+  if (!t_rstr->m_heap.m_data) {
+    fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  t_rstr->m_heap.m_capacity = _RSTR_CAP_ENCODE(t_new_capacity);
 }
 
 /// @brief Set the capacity of a string.
@@ -176,21 +1752,39 @@ RSTR_INTERNAL_DEF inline void _rstr_realloc(const char *t_file, int t_line,
 
 /// @brief Returns a pointer to a null-terminated character array with data
 /// equivalent to those stored in the string.
+///
+/// Like `rsv_rstr()`, it points into the struct for short strings.
 static inline const char *rstr_cstr(struct rstr *t_rstr) {
-  if (t_rstr->m_data[rstr_size(t_rstr)] != '\0') {
-    t_rstr->m_data[rstr_size(t_rstr)] = '\0';
+  char *data = _rstr_ptr(t_rstr);
+  if (data[rstr_size(t_rstr)] != '\0') {
+    data[rstr_size(t_rstr)] = '\0';
   }
-  return t_rstr->m_data;
+  return data;
 }
 /// @brief Returns a pointer to a possibly non null-terminated character array
 /// with data equivalent to those stored in the string.
 static inline const char *rstr_data(struct rstr *t_rstr) {
-  return t_rstr->m_data;
+  return _rstr_ptr(t_rstr);
+}
+
+/// @brief Hash a string, same as `rsv_hash()` on a view of it.
+///
+/// With RSTR_CACHE_HASH defined, the hash is only computed the first time
+/// after the string changed.
+static inline uint64_t rstr_hash(struct rstr *t_rstr) {
+#ifdef RSTR_CACHE_HASH
+  if (t_rstr->m_hash == 0) {
+    t_rstr->m_hash = rsv_hash(rsv_rstr(t_rstr));
+  }
+  return t_rstr->m_hash;
+#else
+  return rsv_hash(rsv_rstr(t_rstr));
+#endif // RSTR_CACHE_HASH
 }
 
 /// @brief A helper macro to print `rstr` without relyin on null terminator
 /// character
-#define rstr_fmt(t_rstr) (int)(t_rstr)->m_size, (t_rstr)->m_data
+#define rstr_fmt(t_rstr) (int)rstr_size(t_rstr), rstr_data(t_rstr)
 
 static inline void rstr_print(struct rstr *t_rstr) {
   printf("%.*s", rstr_fmt(t_rstr));
@@ -199,8 +1793,12 @@ static inline void rstr_println(struct rstr *t_rstr) {
   printf("%.*s\n", rstr_fmt(t_rstr));
 }
 
+/// @brief Free the memory of a string, leaving it empty.
 static inline void rstr_free(struct rstr *t_rstr, rstr_allocator *t_allocator) {
-  t_allocator->free(t_allocator->m_ctx, t_rstr->m_data);
+  if (_rstr_is_heap(t_rstr)) {
+    t_allocator->free(t_allocator->m_ctx, t_rstr->m_heap.m_data);
+  }
+  *t_rstr = (struct rstr){};
 }
 
 /// @param Check if a string is empty.
@@ -208,24 +1806,24 @@ static inline void rstr_free(struct rstr *t_rstr, rstr_allocator *t_allocator) {
 
 /// @brief Empty out a string.
 static inline void rstr_clear(struct rstr *t_rstr) {
-  t_rstr->m_size = 0;
-  t_rstr->m_data[0] = '\0';
+  _rstr_set_size(t_rstr, 0);
+  _rstr_ptr(t_rstr)[0] = '\0';
 }
 
 /// @brief Create a rstr.
 #define rstr(t_rstr, t_rsv, t_allocator)                                       \
   struct rstr t_rstr = {};                                                     \
   rstr_init(&t_rstr, rsv_size(t_rsv), (t_allocator));                          \
-  memcpy(t_rstr.m_data, (t_rsv).m_str, rsv_size(t_rsv));                       \
-  t_rstr.m_data[rsv_size(t_rsv)] = '\0'
+  memcpy(_rstr_ptr(&t_rstr), (t_rsv).m_str, rsv_size(t_rsv));                  \
+  _rstr_ptr(&t_rstr)[rsv_size(t_rsv)] = '\0'
 
 #define rstr_ret_ptr_at_index(t_rstr, t_index)                                 \
   (((t_index) >= rstr_size(t_rstr))                                            \
        ? (fprintf(stderr,                                                      \
                   "Error: array index out of bounds, file: %s, line: %d\n",    \
                   __FILE__, __LINE__),                                         \
-          exit(EXIT_FAILURE), &((t_rstr)->m_data[t_index]))                    \
-       : &((t_rstr)->m_data[t_index]))
+          exit(EXIT_FAILURE), &(_rstr_mut_ptr(t_rstr)[t_index]))               \
+       : &(_rstr_mut_ptr(t_rstr)[t_index]))
 
 #define rstr_at(t_rstr, t_index) (*(rstr_ret_ptr_at_index(t_rstr, t_index)))
 
@@ -247,11 +1845,10 @@ _rstr_cp_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
             t_file, t_line);
     exit(EXIT_FAILURE);
   }
-  _rstr_init_with_location(t_file, t_line, t_rstr, t_size - t_index,
-                           t_allocator);
-  for (size_t i = 0, j = t_index; i < t_size; i++, j++) {
-    rstr_at(t_rstr, i) = rstr_at(t_rstr_other, j);
-  }
+  _rstr_init_with_location(t_file, t_line, t_rstr, t_size, t_allocator);
+  char *data = _rstr_ptr(t_rstr);
+  memcpy(data, rstr_data(t_rstr_other) + t_index, t_size);
+  data[t_size] = '\0';
 }
 
 /// @param t_rstr Where to copy
@@ -263,18 +1860,20 @@ _rstr_cp_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
                          (t_index), (t_size), (t_allocator))
 /// @brief Get the pointer to the first element of an array
 static inline const char *rstr_begin(struct rstr *t_rstr) {
-  return (const char *)&(t_rstr->m_data[0]);
+  return (const char *)_rstr_ptr(t_rstr);
 }
 /// @brief Get the pointer to the past-the-end element of an array
 static inline const char *rstr_end(struct rstr *t_rstr) {
-  return (const char *)&(t_rstr->m_data[rstr_size(t_rstr)]);
+  return (const char *)&(_rstr_ptr(t_rstr)[rstr_size(t_rstr)]);
 }
 
 /// @brief Get the first element of an array
-static inline char rstr_front(struct rstr *t_rstr) { return t_rstr->m_data[0]; }
+static inline char rstr_front(struct rstr *t_rstr) {
+  return _rstr_ptr(t_rstr)[0];
+}
 /// @brief Get the last element of an array
 static inline char rstr_back(struct rstr *t_rstr) {
-  return t_rstr->m_data[rstr_size(t_rstr) - 1];
+  return _rstr_ptr(t_rstr)[rstr_size(t_rstr) - 1];
 }
 
 static inline void rstr_push_back(struct rstr *t_rstr, char t_char,
@@ -282,34 +1881,97 @@ static inline void rstr_push_back(struct rstr *t_rstr, char t_char,
   if (rstr_capacity(t_rstr) <= rstr_size(t_rstr) + 1) {
     rstr_reserve(t_rstr, (rstr_size(t_rstr) + 1) * 2, t_allocator);
   }
-  t_rstr->m_data[rstr_size(t_rstr)] = t_char;
-  t_rstr->m_size++;
-  t_rstr->m_data[rstr_size(t_rstr)] = '\0';
+  size_t size = rstr_size(t_rstr);
+  char *data = _rstr_ptr(t_rstr);
+  data[size] = t_char;
+  data[size + 1] = '\0';
+  _rstr_set_size(t_rstr, size + 1);
 }
 
 static inline void rstr_pop_back(struct rstr *t_rstr) {
-  t_rstr->m_size--;
-  t_rstr->m_data[rstr_size(t_rstr)] = '\0';
+  size_t size = rstr_size(t_rstr) - 1;
+  _rstr_set_size(t_rstr, size);
+  _rstr_ptr(t_rstr)[size] = '\0';
+}
+
+/// @internal
+/// @brief Make room for at least t_capacity bytes, growing geometrically
+static inline void _rstr_grow(struct rstr *t_rstr, size_t t_capacity,
+                              rstr_allocator *t_allocator) {
+  if (rstr_capacity(t_rstr) < t_capacity) {
+    size_t capacity = rstr_capacity(t_rstr) * 2;
+    rstr_reserve(t_rstr, capacity < t_capacity ? t_capacity : capacity,
+                 t_allocator);
+  }
+}
+
+/// @internal
+/// @brief Replace t_count characters at t_index with t_size bytes of t_src.
+///
+/// t_src may point into the string itself. Its offset is remembered across
+/// the reallocation, and the bytes are moved in an order that never
+/// overwrites a part of the source before it is copied.
+RSTR_INTERNAL_DEF inline void _rstr_splice(struct rstr *t_rstr, size_t t_index,
+                                           size_t t_count, const char *t_src,
+                                           size_t t_size,
+                                           rstr_allocator *t_allocator) {
+  size_t size = rstr_size(t_rstr);
+  size_t new_size = size - t_count + t_size;
+  size_t tail = t_index + t_count;
+  char *data = _rstr_ptr(t_rstr);
+  bool inside = (uintptr_t)t_src >= (uintptr_t)data &&
+                (uintptr_t)t_src < (uintptr_t)(data + size);
+  size_t src_offset = inside ? (size_t)(t_src - data) : 0;
+  _rstr_grow(t_rstr, new_size + 1, t_allocator);
+  data = _rstr_ptr(t_rstr);
+  if (inside) {
+    t_src = data + src_offset;
+  }
+
+  if (t_size <= t_count) {
+    // The source is read before the tail moves, and it is written in front of
+    // the tail
+    memmove(data + t_index, t_src, t_size);
+    memmove(data + t_index + t_size, data + tail, size - tail);
+  } else {
+    memmove(data + t_index + t_size, data + tail, size - tail);
+    // The part of the source inside the tail has moved with it
+    size_t unmoved = t_size;
+    if (inside) {
+      unmoved = src_offset >= tail ? 0 : tail - src_offset;
+      unmoved = unmoved < t_size ? unmoved : t_size;
+    }
+    memmove(data + t_index, t_src, unmoved);
+    if (unmoved < t_size) {
+      memcpy(data + t_index + unmoved,
+             t_src + unmoved + (t_size - t_count), t_size - unmoved);
+    }
+  }
+  data[new_size] = '\0';
+  _rstr_set_size(t_rstr, new_size);
 }
 
 static inline void rstr_append_char(struct rstr *t_rstr, size_t t_size,
                                     char t_char, rstr_allocator *t_allocator) {
-  for (size_t i = 1; i <= t_size; i++) {
-    rstr_push_back(t_rstr, t_char, t_allocator);
-  }
+  size_t size = rstr_size(t_rstr);
+  _rstr_grow(t_rstr, size + t_size + 1, t_allocator);
+  char *data = _rstr_ptr(t_rstr);
+  memset(data + size, t_char, t_size);
+  data[size + t_size] = '\0';
+  _rstr_set_size(t_rstr, size + t_size);
 }
 
+/// @brief Append a string, t_rsv may be a view of t_rstr itself.
 static inline void rstr_append_str(struct rstr *t_rstr, rsv t_rsv,
                                    rstr_allocator *t_allocator) {
-  for (size_t i = 0; i < rsv_size(t_rsv); i++) {
-    rstr_push_back(t_rstr, rsv_at(t_rsv, i), t_allocator);
-  }
+  _rstr_splice(t_rstr, rstr_size(t_rstr), 0, rsv_data(t_rsv), rsv_size(t_rsv),
+               t_allocator);
 }
 
 static inline void rstr_remove(struct rstr *t_rstr, size_t t_size) {
-  for (size_t i = 1; i <= t_size; i++) {
-    rstr_pop_back(t_rstr);
-  }
+  size_t size = rstr_size(t_rstr) - t_size;
+  _rstr_set_size(t_rstr, size);
+  _rstr_ptr(t_rstr)[size] = '\0';
 }
 
 static inline void rstr_resize(struct rstr *t_rstr, size_t t_size, char t_char,
@@ -318,32 +1980,58 @@ static inline void rstr_resize(struct rstr *t_rstr, size_t t_size, char t_char,
   rstr_append_char(t_rstr, t_size, t_char, t_allocator);
 }
 
-/// @brief Insert characters in the array at t_index.
-static inline void rstr_insert(struct rstr *t_rstr, size_t t_index,
-                               size_t t_size, char t_char,
-                               rstr_allocator *t_allocator) {
-  rstr_append_char(t_rstr, t_size, t_char, t_allocator);
-  for (size_t i = rstr_size(t_rstr) - 1; i >= t_index + t_size; i--) {
-    rstr_at(t_rstr, i) = rstr_at(t_rstr, i - t_size);
-    rstr_at(t_rstr, i - t_size) = t_char;
+/// @internal
+RSTR_INTERNAL_DEF inline void
+_rstr_insert_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
+                           size_t t_index, size_t t_size, char t_char,
+                           rstr_allocator *t_allocator) {
+  size_t size = rstr_size(t_rstr);
+  if (t_index > size) {
+    fprintf(stderr,
+            "Error: index out of bounds of the string, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
   }
+  _rstr_grow(t_rstr, size + t_size + 1, t_allocator);
+  char *data = _rstr_ptr(t_rstr);
+  memmove(data + t_index + t_size, data + t_index, size - t_index);
+  memset(data + t_index, t_char, t_size);
+  data[size + t_size] = '\0';
+  _rstr_set_size(t_rstr, size + t_size);
 }
 
-/// @brief Remove characters in the array at t_index.
-static inline void rstr_erase(struct rstr *t_rstr, size_t t_index,
-                              size_t t_size) {
-  for (size_t i = t_index + t_size; i < rstr_size(t_rstr); i++) {
-    rstr_at(t_rstr, i - t_size) = rstr_at(t_rstr, i);
+/// @brief Insert characters in the array at t_index.
+#define rstr_insert(t_rstr, t_index, t_size, t_char, t_allocator)              \
+  _rstr_insert_with_location(__FILE__, __LINE__, (t_rstr), (t_index),          \
+                             (t_size), (t_char), (t_allocator))
+
+/// @internal
+RSTR_INTERNAL_DEF inline void
+_rstr_erase_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
+                          size_t t_index, size_t t_size) {
+  size_t size = rstr_size(t_rstr);
+  if (t_index > size || t_size > size - t_index) {
+    fprintf(stderr,
+            "Error: characters to erase out of bounds of the string, file: %s, "
+            "line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
   }
+  char *data = _rstr_ptr(t_rstr);
+  memmove(data + t_index, data + t_index + t_size, size - t_index - t_size);
   rstr_remove(t_rstr, t_size);
 }
 
+/// @brief Remove characters in the array at t_index.
+#define rstr_erase(t_rstr, t_index, t_size)                                    \
+  _rstr_erase_with_location(__FILE__, __LINE__, (t_rstr), (t_index), (t_size))
+
 /// @param t_rstr Where to assign
-/// @param t_rsv What to assign
+/// @param t_rsv What to assign, it may be a view of t_rstr itself
 static inline void rstr_assign(struct rstr *t_rstr, rsv t_rsv,
                                rstr_allocator *t_allocator) {
-  rstr_clear(t_rstr);
-  rstr_append_str(t_rstr, t_rsv, t_allocator);
+  _rstr_splice(t_rstr, 0, rstr_size(t_rstr), rsv_data(t_rsv), rsv_size(t_rsv),
+               t_allocator);
 }
 
 /// @internal
@@ -369,16 +2057,8 @@ _rstr_replace_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
             t_file, t_line);
     exit(EXIT_FAILURE);
   }
-  if (t_size < rsv_size(t_rsv)) {
-    size_t count = rsv_size(t_rsv) - t_size;
-    rstr_insert(t_rstr, t_index, count, ' ', t_allocator);
-  } else if (t_size > rsv_size(t_rsv)) {
-    size_t count = t_size - rsv_size(t_rsv);
-    rstr_erase(t_rstr, t_index, count);
-  }
-  for (size_t i = t_index, j = 0; j < rsv_size(t_rsv); i++, j++) {
-    rstr_at(t_rstr, i) = rsv_at(t_rsv, j);
-  }
+  _rstr_splice(t_rstr, t_index, t_size, rsv_data(t_rsv), rsv_size(t_rsv),
+               t_allocator);
 }
 
 /// @param t_index Starting index of the substring
@@ -387,21 +2067,773 @@ _rstr_replace_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
   _rstr_replace_with_location(__FILE__, __LINE__, t_rstr, t_index, t_size,     \
                               t_rsv, t_allocator)
 
-/// @brief Extracts characters from a input stream until \n is reached and
-/// stores them in a rstr
-static inline void rstr_getline(FILE *t_istream, struct rstr *t_rstr,
+/// @internal
+/// @brief Number of decimal digits of t_val
+static inline size_t _rstr_count_digits(uint64_t t_val) {
+  size_t count = 1;
+  for (;;) {
+    if (t_val < 10) {
+      return count;
+    }
+    if (t_val < 100) {
+      return count + 1;
+    }
+    if (t_val < 1000) {
+      return count + 2;
+    }
+    if (t_val < 10000) {
+      return count + 3;
+    }
+    t_val /= 10000;
+    count += 4;
+  }
+}
+
+/// @internal
+/// @brief Write the digits of t_val backwards, ending right before t_end
+static inline void _rstr_write_u64(char *t_end, uint64_t t_val) {
+  // Two digits per division, half as many divisions as digits
+  static const char digit_pairs[] =
+      "00010203040506070809101112131415161718192021222324"
+      "25262728293031323334353637383940414243444546474849"
+      "50515253545556575859606162636465666768697071727374"
+      "75767778798081828384858687888990919293949596979899";
+  while (t_val >= 100) {
+    size_t pair = (size_t)(t_val % 100) * 2;
+    t_val /= 100;
+    t_end -= 2;
+    memcpy(t_end, digit_pairs + pair, 2);
+  }
+  if (t_val >= 10) {
+    memcpy(t_end - 2, digit_pairs + t_val * 2, 2);
+  } else {
+    t_end[-1] = (char)('0' + t_val);
+  }
+}
+
+/// @internal
+/// @brief Make room for t_size more characters and return where they go, the
+/// size is already updated
+static inline char *_rstr_append_space(struct rstr *t_rstr, size_t t_size,
+                                       rstr_allocator *t_allocator) {
+  size_t size = rstr_size(t_rstr);
+  _rstr_grow(t_rstr, size + t_size + 1, t_allocator);
+  char *data = _rstr_ptr(t_rstr);
+  data[size + t_size] = '\0';
+  _rstr_set_size(t_rstr, size + t_size);
+  return data + size;
+}
+
+/// @brief Append the decimal digits of an unsigned integer.
+static inline void rstr_append_u64(struct rstr *t_rstr, uint64_t t_val,
+                                   rstr_allocator *t_allocator) {
+  size_t digit_count = _rstr_count_digits(t_val);
+  char *dest = _rstr_append_space(t_rstr, digit_count, t_allocator);
+  _rstr_write_u64(dest + digit_count, t_val);
+}
+
+/// @brief Append a signed integer, with a '-' if it is negative.
+static inline void rstr_append_i64(struct rstr *t_rstr, int64_t t_val,
+                                   rstr_allocator *t_allocator) {
+  // 0 - x is done unsigned, so INT64_MIN doesn't overflow
+  uint64_t magnitude = t_val < 0 ? 0 - (uint64_t)t_val : (uint64_t)t_val;
+  size_t digit_count = _rstr_count_digits(magnitude) + (t_val < 0);
+  char *dest = _rstr_append_space(t_rstr, digit_count, t_allocator);
+  if (t_val < 0) {
+    dest[0] = '-';
+  }
+  _rstr_write_u64(dest + digit_count, magnitude);
+}
+
+/// @brief Append an unsigned integer as lower case hexadecimal digits,
+/// without a 0x prefix.
+/// @param t_min_digits The number is padded with zeros to at least this many
+/// digits, 0 or 1 for no padding
+static inline void rstr_append_hex(struct rstr *t_rstr, uint64_t t_val,
+                                   size_t t_min_digits,
+                                   rstr_allocator *t_allocator) {
+  size_t digit_count = 1;
+  while (digit_count < 16 && t_val >> (digit_count * 4)) {
+    digit_count++;
+  }
+  if (digit_count < t_min_digits) {
+    digit_count = t_min_digits;
+  }
+  char *dest = _rstr_append_space(t_rstr, digit_count, t_allocator);
+  for (size_t i = digit_count; i > 0; i--) {
+    dest[i - 1] = "0123456789abcdef"[t_val & 15];
+    t_val >>= 4;
+  }
+}
+
+/// @brief Append the shortest of the 15, 16 and 17 digit decimal forms of a
+/// double that reads back as the same double.
+///
+/// It is written like printf()'s %g, so it is not always the shortest form
+/// overall, 5e-324 is written as 4.94065645841247e-324. '.' is the decimal
+/// point whatever the locale is, infinities and NaN are written as inf, -inf
+/// and nan.
+static inline void rstr_append_f64(struct rstr *t_rstr, double t_val,
+                                   rstr_allocator *t_allocator) {
+  if (t_val != t_val) {
+    rstr_append_str(t_rstr, rsv_lit("nan"), t_allocator);
+    return;
+  }
+  if (t_val == HUGE_VAL || t_val == -HUGE_VAL) {
+    rstr_append_str(t_rstr, t_val < 0 ? rsv_lit("-inf") : rsv_lit("inf"),
+                    t_allocator);
+    return;
+  }
+  // "-d.dddddddddddddddde-ddd" needs 24 characters plus the terminator
+  size_t size = rstr_size(t_rstr);
+  _rstr_grow(t_rstr, size + 32, t_allocator);
+  char *dest = _rstr_ptr(t_rstr) + size;
+  // The decimal point of the locale may be more than one byte long
+  const char *decimal_point = localeconv()->decimal_point;
+  size_t point_size = strlen(decimal_point);
+  bool replace_point = point_size > 0 && strcmp(decimal_point, ".") != 0;
+  int length = 0;
+  for (int precision = 15; precision <= 17; precision++) {
+    length = snprintf(dest, 32, "%.*g", precision, t_val);
+    char *point = replace_point ? strstr(dest, decimal_point) : NULL;
+    if (point) {
+      *point = '.';
+      memmove(point + 1, point + point_size,
+              (size_t)(dest + length - point) - point_size + 1);
+      length -= (int)point_size - 1;
+    }
+    double parsed = 0;
+    if (rsv_parse_f64((rsv){.m_size = (size_t)length, .m_str = dest},
+                      &parsed) &&
+        parsed == t_val) {
+      break;
+    }
+  }
+  _rstr_set_size(t_rstr, size + (size_t)length);
+}
+
+/// @internal
+RSTR_INTERNAL_DEF inline void
+_rstr_vappendf_with_location(const char *t_file, int t_line,
+                             struct rstr *t_rstr, rstr_allocator *t_allocator,
+                             const char *t_format, va_list t_args) {
+  size_t size = rstr_size(t_rstr);
+  size_t space = rstr_capacity(t_rstr) - size;
+  va_list args;
+  va_copy(args, t_args);
+  // Try the space that is already there first, most of the time it is enough
+  int length = vsnprintf(_rstr_ptr(t_rstr) + size, space, t_format, args);
+  va_end(args);
+  if (length < 0) {
+    fprintf(stderr, "Error: formatting failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  if ((size_t)length >= space) {
+    _rstr_grow(t_rstr, size + (size_t)length + 1, t_allocator);
+    vsnprintf(_rstr_ptr(t_rstr) + size, (size_t)length + 1, t_format, t_args);
+  }
+  _rstr_set_size(t_rstr, size + (size_t)length);
+}
+
+/// @internal
+#if defined(__GNUC__)
+__attribute__((format(printf, 5, 6)))
+#endif // __GNUC__
+RSTR_INTERNAL_DEF inline void
+_rstr_appendf_with_location(const char *t_file, int t_line, struct rstr *t_rstr,
+                            rstr_allocator *t_allocator, const char *t_format,
+                            ...) {
+  va_list args;
+  va_start(args, t_format);
+  _rstr_vappendf_with_location(t_file, t_line, t_rstr, t_allocator, t_format,
+                               args);
+  va_end(args);
+}
+
+/// @brief Append printf() style formatted text.
+///
+/// The text is formatted right into the free capacity of the rstr, there is
+/// no temporary buffer.
+#define rstr_appendf(t_rstr, t_allocator, ...)                                 \
+  _rstr_appendf_with_location(__FILE__, __LINE__, t_rstr, t_allocator,         \
+                              __VA_ARGS__)
+
+/// @brief Same as `rstr_appendf()`, with a va_list.
+#define rstr_vappendf(t_rstr, t_allocator, t_format, t_args)                   \
+  _rstr_vappendf_with_location(__FILE__, __LINE__, t_rstr, t_allocator,        \
+                               t_format, t_args)
+
+/// @internal
+/// @brief Write the ascii lower or upper case of t_size characters to t_dest,
+/// t_dest may be t_src.
+static inline void _rstr_ascii_case(char *t_dest, const char *t_src,
+                                    size_t t_size, bool t_upper) {
+  size_t i = 0;
+#ifdef _RSV_SSE2
+  // Lower case letters get bit 0x20 set, upper case letters get it cleared
+  char first = t_upper ? 'a' : 'A';
+  __m128i bit = _mm_set1_epi8(0x20);
+  for (; i + 16 <= t_size; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(t_src + i));
+    __m128i flip = _mm_and_si128(_rsv_ascii_range_sse2(block, first), bit);
+    _mm_storeu_si128((__m128i *)(t_dest + i), _mm_xor_si128(block, flip));
+  }
+#endif // _RSV_SSE2
+  for (; i < t_size; i++) {
+    t_dest[i] = t_upper ? _rsv_ascii_upper(t_src[i])
+                        : _rsv_ascii_lower(t_src[i]);
+  }
+}
+
+/// @internal
+/// @brief Append t_rsv in ascii lower or upper case, t_rsv may be a view of
+/// t_rstr itself, its offset is remembered across the reallocation.
+static inline void _rstr_append_case(struct rstr *t_rstr, rsv t_rsv,
+                                     bool t_upper,
+                                     rstr_allocator *t_allocator) {
+  const char *data = _rstr_ptr(t_rstr);
+  const char *src = rsv_data(t_rsv);
+  bool inside = (uintptr_t)src >= (uintptr_t)data &&
+                (uintptr_t)src < (uintptr_t)(data + rstr_size(t_rstr));
+  size_t src_offset = inside ? (size_t)(src - data) : 0;
+  char *dest = _rstr_append_space(t_rstr, rsv_size(t_rsv), t_allocator);
+  if (inside) {
+    src = _rstr_ptr(t_rstr) + src_offset;
+  }
+  _rstr_ascii_case(dest, src, rsv_size(t_rsv), t_upper);
+}
+
+/// @brief Append a rsv converted to ascii lower case, other bytes are copied
+/// as they are. t_rsv may be a view of t_rstr itself.
+static inline void rstr_append_lower(struct rstr *t_rstr, rsv t_rsv,
+                                     rstr_allocator *t_allocator) {
+  _rstr_append_case(t_rstr, t_rsv, false, t_allocator);
+}
+
+/// @brief Append a rsv converted to ascii upper case, other bytes are copied
+/// as they are. t_rsv may be a view of t_rstr itself.
+static inline void rstr_append_upper(struct rstr *t_rstr, rsv t_rsv,
+                                     rstr_allocator *t_allocator) {
+  _rstr_append_case(t_rstr, t_rsv, true, t_allocator);
+}
+
+/// @brief Convert a rstr to ascii lower case in place.
+static inline void rstr_to_lower(struct rstr *t_rstr) {
+  _rstr_ascii_case(_rstr_mut_ptr(t_rstr), _rstr_ptr(t_rstr),
+                   rstr_size(t_rstr), false);
+}
+
+/// @brief Convert a rstr to ascii upper case in place.
+static inline void rstr_to_upper(struct rstr *t_rstr) {
+  _rstr_ascii_case(_rstr_mut_ptr(t_rstr), _rstr_ptr(t_rstr),
+                   rstr_size(t_rstr), true);
+}
+
+/// @internal
+/// @brief Header in front of the characters of a rstr_shared
+struct _rstr_shared_buf {
+  long m_refs;       // Do not modify this, this is private
+  size_t m_size;     // Do not modify this, this is private
+  size_t m_capacity; // Do not modify this, this is private
+};
+
+/// @brief Reference counted string, copies share the characters until one of
+/// them changes.
+///
+/// Copying only increments the count, a function changing the string first
+/// copies the characters if anybody else still holds them. The count is
+/// atomic, so copies of one string can be used and freed from different
+/// threads, a single rstr_shared can't. A zero initialized rstr_shared is a
+/// valid empty string.
+struct rstr_shared {
+  struct _rstr_shared_buf *m_buf; // Do not modify this, this is private
+};
+
+/// @internal
+static inline char *_rstr_shared_chars(struct _rstr_shared_buf *t_buf) {
+  return (char *)(t_buf + 1);
+}
+
+/// @internal
+static inline void _rstr_shared_ref(struct _rstr_shared_buf *t_buf) {
+#ifdef _MSC_VER
+  _InterlockedIncrement(&t_buf->m_refs);
+#else
+  __atomic_add_fetch(&t_buf->m_refs, 1, __ATOMIC_RELAXED);
+#endif // _MSC_VER
+}
+
+/// @internal
+/// @return The count after the decrement
+static inline long _rstr_shared_unref(struct _rstr_shared_buf *t_buf) {
+#ifdef _MSC_VER
+  return _InterlockedDecrement(&t_buf->m_refs);
+#else
+  return __atomic_sub_fetch(&t_buf->m_refs, 1, __ATOMIC_ACQ_REL);
+#endif // _MSC_VER
+}
+
+/// @brief Number of rstr_shared holding the characters, 0 for an empty string
+/// that holds none.
+static inline long rstr_shared_use_count(struct rstr_shared *t_shared) {
+  if (t_shared->m_buf == NULL) {
+    return 0;
+  }
+#ifdef _MSC_VER
+  return _InterlockedCompareExchange(&t_shared->m_buf->m_refs, 0, 0);
+#else
+  return __atomic_load_n(&t_shared->m_buf->m_refs, __ATOMIC_ACQUIRE);
+#endif // _MSC_VER
+}
+
+static inline size_t rstr_shared_size(struct rstr_shared *t_shared) {
+  return t_shared->m_buf ? t_shared->m_buf->m_size : 0;
+}
+
+/// @brief Get the null-terminated characters, they are shared with the copies
+/// of the string and must not be written.
+static inline const char *rstr_shared_data(struct rstr_shared *t_shared) {
+  return t_shared->m_buf ? _rstr_shared_chars(t_shared->m_buf) : "";
+}
+
+/// @brief Create a rsv from rstr_shared
+static inline rsv rsv_rstr_shared(struct rstr_shared *t_shared) {
+  return (rsv){.m_size = rstr_shared_size(t_shared),
+               .m_str = rstr_shared_data(t_shared)};
+}
+
+/// @brief Copy a rstr_shared, only the reference count is changed.
+/// @param t_shared Has to be empty or freed, it is overwritten
+static inline void rstr_shared_copy(struct rstr_shared *t_shared,
+                                    struct rstr_shared *t_shared_other) {
+  t_shared->m_buf = t_shared_other->m_buf;
+  if (t_shared->m_buf) {
+    _rstr_shared_ref(t_shared->m_buf);
+  }
+}
+
+/// @brief Drop this reference, the characters are freed with the last one.
+static inline void rstr_shared_free(struct rstr_shared *t_shared,
+                                    rstr_allocator *t_allocator) {
+  if (t_shared->m_buf && _rstr_shared_unref(t_shared->m_buf) == 0) {
+    t_allocator->free(t_allocator->m_ctx, t_shared->m_buf);
+  }
+  t_shared->m_buf = NULL;
+}
+
+/// @internal
+/// @brief Replace t_count characters at t_index with t_size characters from
+/// t_src.
+///
+/// The characters are changed in place only if nobody else holds them and
+/// t_src is not inside of them, otherwise the result is built in a new
+/// buffer and this reference to the old one is dropped.
+RSTR_INTERNAL_DEF inline void
+_rstr_shared_splice(const char *t_file, int t_line,
+                    struct rstr_shared *t_shared, size_t t_index,
+                    size_t t_count, const char *t_src, size_t t_size,
+                    size_t t_min_capacity, rstr_allocator *t_allocator) {
+  struct _rstr_shared_buf *buf = t_shared->m_buf;
+  size_t size = rstr_shared_size(t_shared);
+  size_t new_size = size - t_count + t_size;
+  size_t needed = new_size + 1 > t_min_capacity ? new_size + 1 : t_min_capacity;
+  size_t capacity = buf ? buf->m_capacity : 0;
+  if (buf == NULL && needed == 1) {
+    return;
+  }
+  if (needed > capacity) {
+    capacity = capacity * 2 < needed ? needed : capacity * 2;
+  }
+  char *data = buf ? _rstr_shared_chars(buf) : NULL;
+  bool inside = data && (uintptr_t)t_src >= (uintptr_t)data &&
+                (uintptr_t)t_src < (uintptr_t)(data + size);
+  if (buf && !inside && rstr_shared_use_count(t_shared) == 1) {
+    if (capacity != buf->m_capacity) {
+      buf = (struct _rstr_shared_buf *)t_allocator->realloc(
+          t_allocator->m_ctx, buf, sizeof(*buf) + buf->m_capacity,
+          sizeof(*buf) + capacity);
+      if (!buf) {
+        fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n",
+                t_file, t_line);
+        exit(EXIT_FAILURE);
+      }
+      buf->m_capacity = capacity;
+      t_shared->m_buf = buf;
+      data = _rstr_shared_chars(buf);
+    }
+    memmove(data + t_index + t_size, data + t_index + t_count,
+            size - t_index - t_count);
+    if (t_size) {
+      memcpy(data + t_index, t_src, t_size);
+    }
+  } else {
+    struct _rstr_shared_buf *new_buf =
+        (struct _rstr_shared_buf *)t_allocator->alloc(
+            t_allocator->m_ctx, sizeof(*new_buf) + capacity);
+    if (!new_buf) {
+      fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n",
+              t_file, t_line);
+      exit(EXIT_FAILURE);
+    }
+    new_buf->m_refs = 1;
+    new_buf->m_capacity = capacity;
+    char *new_data = _rstr_shared_chars(new_buf);
+    if (data) {
+      memcpy(new_data, data, t_index);
+      memcpy(new_data + t_index + t_size, data + t_index + t_count,
+             size - t_index - t_count);
+    }
+    if (t_size) {
+      memcpy(new_data + t_index, t_src, t_size);
+    }
+    // The source may be in the old characters, so they go last
+    rstr_shared_free(t_shared, t_allocator);
+    t_shared->m_buf = buf = new_buf;
+    data = new_data;
+  }
+  data[new_size] = '\0';
+  buf->m_size = new_size;
+}
+
+/// @brief Create a rstr_shared holding a copy of t_rsv.
+/// @param t_shared Has to be empty or freed, it is overwritten
+static inline void rstr_shared_init(struct rstr_shared *t_shared, rsv t_rsv,
+                                    rstr_allocator *t_allocator) {
+  t_shared->m_buf = NULL;
+  if (rsv_size(t_rsv)) {
+    _rstr_shared_splice(__FILE__, __LINE__, t_shared, 0, 0, rsv_data(t_rsv),
+                        rsv_size(t_rsv), 0, t_allocator);
+  }
+}
+
+/// @brief Make sure this string is the only one holding its characters and
+/// has room for t_capacity characters, including the null terminator.
+static inline void rstr_shared_reserve(struct rstr_shared *t_shared,
+                                       size_t t_capacity,
+                                       rstr_allocator *t_allocator) {
+  _rstr_shared_splice(__FILE__, __LINE__, t_shared, rstr_shared_size(t_shared),
+                      0, NULL, 0, t_capacity, t_allocator);
+}
+
+static inline void rstr_shared_push_back(struct rstr_shared *t_shared,
+                                         char t_char,
+                                         rstr_allocator *t_allocator) {
+  _rstr_shared_splice(__FILE__, __LINE__, t_shared, rstr_shared_size(t_shared),
+                      0, &t_char, 1, 0, t_allocator);
+}
+
+/// @param t_rsv What to append, it may be a view of t_shared itself
+static inline void rstr_shared_append(struct rstr_shared *t_shared, rsv t_rsv,
+                                      rstr_allocator *t_allocator) {
+  _rstr_shared_splice(__FILE__, __LINE__, t_shared, rstr_shared_size(t_shared),
+                      0, rsv_data(t_rsv), rsv_size(t_rsv), 0, t_allocator);
+}
+
+/// @internal
+RSTR_INTERNAL_DEF inline void _rstr_shared_replace_with_location(
+    const char *t_file, int t_line, struct rstr_shared *t_shared,
+    size_t t_index, size_t t_size, rsv t_rsv, rstr_allocator *t_allocator) {
+  size_t size = rstr_shared_size(t_shared);
+  if (t_index > size || t_size > size - t_index) {
+    fprintf(stderr,
+            "Error: characters to replace out of bounds of the string, file: "
+            "%s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  _rstr_shared_splice(t_file, t_line, t_shared, t_index, t_size,
+                      rsv_data(t_rsv), rsv_size(t_rsv), 0, t_allocator);
+}
+
+/// @brief Insert a string at t_index.
+#define rstr_shared_insert(t_shared, t_index, t_rsv, t_allocator)              \
+  _rstr_shared_replace_with_location(__FILE__, __LINE__, (t_shared),           \
+                                     (t_index), 0, (t_rsv), (t_allocator))
+
+/// @brief Remove t_size characters at t_index.
+#define rstr_shared_erase(t_shared, t_index, t_size, t_allocator)              \
+  _rstr_shared_replace_with_location(__FILE__, __LINE__, (t_shared),           \
+                                     (t_index), (t_size), RSV_NULL,            \
+                                     (t_allocator))
+
+/// @brief Replace t_size characters at t_index with a string.
+#define rstr_shared_replace(t_shared, t_index, t_size, t_rsv, t_allocator)     \
+  _rstr_shared_replace_with_location(__FILE__, __LINE__, (t_shared),           \
+                                     (t_index), (t_size), (t_rsv),             \
+                                     (t_allocator))
+
+/// @internal
+RSTR_INTERNAL_DEF inline char *
+_rstr_shared_at_with_location(const char *t_file, int t_line,
+                              struct rstr_shared *t_shared, size_t t_index,
+                              rstr_allocator *t_allocator) {
+  if (t_index >= rstr_shared_size(t_shared)) {
+    fprintf(stderr,
+            "Error: string index is out of bounds, file: %s, line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  if (rstr_shared_use_count(t_shared) > 1) {
+    _rstr_shared_splice(t_file, t_line, t_shared, 0, 0, NULL, 0, 0,
+                        t_allocator);
+  }
+  return &_rstr_shared_chars(t_shared->m_buf)[t_index];
+}
+
+/// @brief Get a writable character, the characters are copied first if they
+/// are shared.
+///
+/// Use `rstr_shared_data()` to only read them.
+#define rstr_shared_at(t_shared, t_index, t_allocator)                         \
+  (*_rstr_shared_at_with_location(__FILE__, __LINE__, (t_shared), (t_index),   \
+                                  (t_allocator)))
+
+/// @brief Extracts characters from a input stream until \n or EOF is reached
+/// and appends them to a rstr, the \n is not stored.
+///
+/// The line is read in chunks of at most 4 KiB with fgets(). Each chunk is
+/// filled with \n beforehand, that way the end of the line can be found even
+/// if it holds null characters. Only the space a chunk needs gets reserved,
+/// it doubles each time a chunk fills up.
+/// @return false if EOF was reached before anything was read
+static inline bool rstr_getline(FILE *t_istream, struct rstr *t_rstr,
                                 rstr_allocator *t_allocator) {
-  for (int ch = fgetc(t_istream); ch != '\n'; ch = fgetc(t_istream)) {
-    rstr_push_back(t_rstr, (char)ch, (t_allocator));
+  const size_t max_window = 4096;
+  bool read_any = false;
+  size_t chunk = 128;
+  for (;;) {
+    size_t size = rstr_size(t_rstr);
+    _rstr_grow(t_rstr, size + chunk, t_allocator);
+    char *data = _rstr_ptr(t_rstr) + size;
+    size_t window = rstr_capacity(t_rstr) - size;
+    window = window < max_window ? window : max_window;
+    memset(data, '\n', window);
+    if (!fgets(data, (int)window, t_istream)) {
+      data[0] = '\0';
+      return read_any;
+    }
+    read_any = true;
+    const char *newline = (const char *)memchr(data, '\n', window);
+    if (newline == NULL) {
+      // The chunk was full, keep on reading into a bigger one
+      _rstr_set_size(t_rstr, size + window - 1);
+      chunk = chunk * 2 < max_window ? chunk * 2 : max_window;
+      continue;
+    }
+    size_t length = (size_t)(newline - data);
+    if (length + 1 < window && data[length + 1] == '\0') {
+      // A \n that was read, followed by the terminator of fgets()
+      data[length] = '\0';
+      _rstr_set_size(t_rstr, size + length);
+      return true;
+    }
+    // A \n from the filling, right after the terminator, EOF was reached
+    _rstr_set_size(t_rstr, size + length - 1);
+    return true;
+  }
+}
+
+/// @internal
+/// @brief Number of bytes left in a stream, 0 if it is unknown
+static inline size_t _rstr_stream_remaining(FILE *t_istream) {
+#if defined(_WIN32)
+  struct _stat64 st;
+  if (_fstat64(_fileno(t_istream), &st) != 0 || !(st.st_mode & _S_IFREG)) {
+    return 0;
+  }
+  long long pos = _ftelli64(t_istream);
+#else
+  struct stat st;
+  if (fstat(fileno(t_istream), &st) != 0 || !S_ISREG(st.st_mode)) {
+    return 0;
+  }
+  long pos = ftell(t_istream);
+#endif // _WIN32
+  if (pos < 0 || st.st_size <= pos) {
+    return 0;
+  }
+  return (size_t)(st.st_size - pos);
+}
+
+/// @brief Size of the block a rstr_reader reads at once
+#define DEFAULT_READER_CAP (64 * 1024)
+
+/// @internal
+/// @param t_utf8 If not NULL, every block is validated right after it is read
+RSTR_INTERNAL_DEF inline void _rstr_getstream(FILE *t_istream,
+                                              struct rstr *t_rstr,
+                                              rstr_allocator *t_allocator,
+                                              struct rsv_utf8_stream *t_utf8) {
+  size_t size = rstr_size(t_rstr);
+  // One extra byte, so reaching EOF doesn't need another chunk
+  rstr_reserve(t_rstr, size + _rstr_stream_remaining(t_istream) + 2,
+               t_allocator);
+  for (;;) {
+    char *data = _rstr_ptr(t_rstr);
+    size_t window = rstr_capacity(t_rstr) - size - 1;
+    // Validating a block while it is still in the cache is almost free
+    if (t_utf8 && window > DEFAULT_READER_CAP) {
+      window = DEFAULT_READER_CAP;
+    }
+    size_t read = fread(data + size, 1, window, t_istream);
+    if (t_utf8) {
+      rsv_utf8_stream_feed(t_utf8, (rsv){.m_size = read, .m_str = data + size});
+    }
+    size += read;
+    data[size] = '\0';
+    _rstr_set_size(t_rstr, size);
+    if (read < window) {
+      return;
+    }
+    _rstr_grow(t_rstr, size + 4096, t_allocator);
   }
 }
 
 /// @brief Extracts characters from a input stream until EOF is reached and
-/// stores them in a rstr
+/// appends them to a rstr
+///
+/// Regular files are read with a single fread() of their size, other streams
+/// are read in growing chunks.
 static inline void rstr_getstream(FILE *t_istream, struct rstr *t_rstr,
                                   rstr_allocator *t_allocator) {
-  for (int ch = fgetc(t_istream); ch != EOF; ch = fgetc(t_istream)) {
-    rstr_push_back(t_rstr, (char)ch, (t_allocator));
+  _rstr_getstream(t_istream, t_rstr, t_allocator, NULL);
+}
+
+/// @brief Same as `rstr_getstream()`, also checking that the stream is valid
+/// UTF-8.
+///
+/// The stream is read in blocks of DEFAULT_READER_CAP bytes, each validated
+/// right after it is read, so the data is only loaded into the cache once.
+/// @return false if the stream is not valid UTF-8, the whole stream is still
+/// appended
+static inline bool rstr_getstream_utf8(FILE *t_istream, struct rstr *t_rstr,
+                                       rstr_allocator *t_allocator) {
+  struct rsv_utf8_stream utf8 = {0};
+  _rstr_getstream(t_istream, t_rstr, t_allocator, &utf8);
+  return rsv_utf8_stream_valid(&utf8);
+}
+
+/// @brief Buffered line reader.
+///
+/// Reads large blocks with fread() and finds the lines with memchr(). A line
+/// inside the block is returned as a view into it, only lines spanning two
+/// blocks are copied, into m_line.
+struct rstr_reader {
+  FILE *m_istream;               // Do not modify this, this is private
+  char *m_buf;                   // Do not modify this, this is private
+  size_t m_capacity;             // Do not modify this, this is private
+  size_t m_begin;                // Do not modify this, this is private
+  size_t m_end;                  // Do not modify this, this is private
+  bool m_eof;                    // Do not modify this, this is private
+  struct rstr m_line;            // Do not modify this, this is private
+  bool m_check_utf8;             // Do not modify this, this is private
+  struct rsv_utf8_stream m_utf8; // Do not modify this, this is private
+};
+
+/// @internal
+RSTR_INTERNAL_DEF inline void
+_rstr_reader_init_with_location(const char *t_file, int t_line,
+                                struct rstr_reader *t_reader, FILE *t_istream,
+                                size_t t_capacity,
+                                rstr_allocator *t_allocator) {
+  *t_reader = (struct rstr_reader){.m_istream = t_istream,
+                                   .m_capacity = t_capacity};
+  t_reader->m_buf = (char *)t_allocator->alloc(t_allocator->m_ctx, t_capacity);
+  if (!t_reader->m_buf) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// @param t_capacity Size of the blocks read at once, DEFAULT_READER_CAP is a
+/// good default
+#define rstr_reader_init(t_reader, t_istream, t_capacity, t_allocator)         \
+  _rstr_reader_init_with_location(__FILE__, __LINE__, (t_reader), (t_istream), \
+                                  (t_capacity), (t_allocator))
+
+static inline void rstr_reader_free(struct rstr_reader *t_reader,
+                                    rstr_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, t_reader->m_buf);
+  rstr_free(&t_reader->m_line, t_allocator);
+}
+
+/// @brief Check that everything read is valid UTF-8, call it before reading
+/// the first line.
+///
+/// Every block is validated right after it is read, see
+/// `rstr_reader_utf8_valid()`.
+static inline void rstr_reader_check_utf8(struct rstr_reader *t_reader) {
+  t_reader->m_check_utf8 = true;
+}
+
+/// @brief Check if everything read so far is valid UTF-8.
+///
+/// Once `rstr_reader_getline()` returned false, this covers the whole stream.
+static inline bool rstr_reader_utf8_valid(struct rstr_reader *t_reader) {
+  return !t_reader->m_utf8.m_error &&
+         (!t_reader->m_eof || t_reader->m_utf8.m_carry_size == 0);
+}
+
+/// @internal
+/// @brief Read the next block, the unread part of the buffer is dropped
+static inline bool _rstr_reader_fill(struct rstr_reader *t_reader) {
+  t_reader->m_begin = 0;
+  t_reader->m_end =
+      fread(t_reader->m_buf, 1, t_reader->m_capacity, t_reader->m_istream);
+  if (t_reader->m_check_utf8) {
+    rsv_utf8_stream_feed(&t_reader->m_utf8,
+                         (rsv){.m_size = t_reader->m_end,
+                               .m_str = t_reader->m_buf});
+  }
+  if (t_reader->m_end == 0) {
+    t_reader->m_eof = true;
+  }
+  return !t_reader->m_eof;
+}
+
+/// @brief Get the next line without its \n.
+///
+/// The view stays valid until the next call.
+/// @return false when there are no lines left
+static inline bool rstr_reader_getline(struct rstr_reader *t_reader,
+                                       rsv *t_line,
+                                       rstr_allocator *t_allocator) {
+  rstr_clear(&t_reader->m_line);
+  bool spanning = false;
+  for (;;) {
+    const char *begin = t_reader->m_buf + t_reader->m_begin;
+    size_t size = t_reader->m_end - t_reader->m_begin;
+    const char *newline = (const char *)memchr(begin, '\n', size);
+    if (newline != NULL) {
+      size = (size_t)(newline - begin);
+      t_reader->m_begin += size + 1;
+    } else {
+      t_reader->m_begin = t_reader->m_end;
+    }
+    if (newline != NULL) {
+      if (!spanning) {
+        *t_line = (rsv){.m_size = size, .m_str = begin};
+        return true;
+      }
+      rstr_append_str(&t_reader->m_line, (rsv){.m_size = size, .m_str = begin},
+                      t_allocator);
+      *t_line = rsv_rstr(&t_reader->m_line);
+      return true;
+    }
+    if (size > 0) {
+      // The line continues in the next block
+      rstr_append_str(&t_reader->m_line, (rsv){.m_size = size, .m_str = begin},
+                      t_allocator);
+      spanning = true;
+    }
+    if (t_reader->m_eof || !_rstr_reader_fill(t_reader)) {
+      if (spanning) {
+        *t_line = rsv_rstr(&t_reader->m_line);
+      }
+      return spanning;
+    }
   }
 }
 
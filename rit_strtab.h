@@ -0,0 +1,375 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RST_INTERNAL_DEF
+#define RST_INTERNAL_DEF static
+#endif // RST_INTERNAL_DEF
+
+#ifndef RIT_STRTAB_H_INCLUDED
+#define RIT_STRTAB_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rit_dyn_arr.h"
+#include "rit_str.h"
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+#define DEFAULT_RST_CAP 256
+
+/// @brief Table of strings, all stored one after the other in one buffer.
+///
+/// String i is the characters from offset i to offset i + 1, so a table of
+/// any number of strings takes two allocations and there is no header per
+/// string. The strings are not null terminated.
+struct rst {
+  size_t m_size;          // Do not modify this, this is private
+  size_t m_capacity;      // Do not modify this, this is private
+  size_t *m_offsets;      // Do not modify this, this is private
+  size_t m_bytes;         // Do not modify this, this is private
+  size_t m_blob_capacity; // Do not modify this, this is private
+  char *m_blob;           // Do not modify this, this is private
+};
+
+/// @brief Iterator over the strings of a rst
+struct rst_iter {
+  struct rst *m_rst; // Do not modify this, this is private
+  size_t m_index;    // Do not modify this, this is private
+};
+
+/// @brief Number of strings stored
+static inline size_t rst_size(struct rst *t_rst) { return t_rst->m_size; }
+
+/// @brief Number of characters stored, in all strings together
+static inline size_t rst_bytes(struct rst *t_rst) { return t_rst->m_bytes; }
+
+/// @internal
+RST_INTERNAL_DEF inline void
+_rst_init_with_location(const char *t_file, int t_line, struct rst *t_rst,
+                        rda_allocator *t_allocator) {
+  *t_rst = (struct rst){};
+  t_rst->m_offsets = (size_t *)t_allocator->alloc(
+      t_allocator->m_ctx, (DEFAULT_ARR_CAP + 1) * sizeof(size_t));
+  t_rst->m_blob = (char *)t_allocator->alloc(t_allocator->m_ctx,
+                                             DEFAULT_RST_CAP);
+  if (!t_rst->m_offsets || !t_rst->m_blob) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  t_rst->m_offsets[0] = 0;
+  t_rst->m_capacity = DEFAULT_ARR_CAP;
+  t_rst->m_blob_capacity = DEFAULT_RST_CAP;
+}
+
+#define rst_init(t_rst, t_allocator)                                           \
+  _rst_init_with_location(__FILE__, __LINE__, (t_rst), (t_allocator))
+
+/// @brief Create an empty rst.
+#define rst(t_rst, t_allocator)                                                \
+  struct rst t_rst;                                                            \
+  rst_init(&t_rst, (t_allocator))
+
+static inline void rst_free(struct rst *t_rst, rda_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, t_rst->m_offsets);
+  t_allocator->free(t_allocator->m_ctx, t_rst->m_blob);
+}
+
+/// @brief Remove all the strings, the memory is kept.
+static inline void rst_clear(struct rst *t_rst) {
+  t_rst->m_size = 0;
+  t_rst->m_bytes = 0;
+}
+
+/// @internal
+RST_INTERNAL_DEF inline void
+_rst_reserve_with_location(const char *t_file, int t_line, struct rst *t_rst,
+                           size_t t_count, size_t t_bytes,
+                           rda_allocator *t_allocator) {
+  if (t_count > t_rst->m_capacity) {
+    size_t capacity = t_rst->m_capacity * 2;
+    capacity = capacity < t_count ? t_count : capacity;
+    t_rst->m_offsets = (size_t *)t_allocator->realloc(
+        t_allocator->m_ctx, t_rst->m_offsets,
+        (t_rst->m_capacity + 1) * sizeof(size_t),
+        (capacity + 1) * sizeof(size_t));
+    if (!t_rst->m_offsets) {
+      fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n",
+              t_file, t_line);
+      exit(EXIT_FAILURE);
+    }
+    t_rst->m_capacity = capacity;
+  }
+  if (t_bytes > t_rst->m_blob_capacity) {
+    size_t capacity = t_rst->m_blob_capacity * 2;
+    capacity = capacity < t_bytes ? t_bytes : capacity;
+    t_rst->m_blob = (char *)t_allocator->realloc(
+        t_allocator->m_ctx, t_rst->m_blob, t_rst->m_blob_capacity, capacity);
+    if (!t_rst->m_blob) {
+      fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n",
+              t_file, t_line);
+      exit(EXIT_FAILURE);
+    }
+    t_rst->m_blob_capacity = capacity;
+  }
+}
+
+/// @brief Make room for t_count strings with t_bytes characters in total.
+#define rst_reserve(t_rst, t_count, t_bytes, t_allocator)                      \
+  _rst_reserve_with_location(__FILE__, __LINE__, (t_rst), (t_count),           \
+                             (t_bytes), (t_allocator))
+
+/// @brief Append a copy of a string.
+/// @param t_rsv It must not be a view of a string of the same rst
+static inline void rst_push_back(struct rst *t_rst, rsv t_rsv,
+                                 rda_allocator *t_allocator) {
+  rst_reserve(t_rst, t_rst->m_size + 1, t_rst->m_bytes + rsv_size(t_rsv),
+              t_allocator);
+  memcpy(t_rst->m_blob + t_rst->m_bytes, rsv_data(t_rsv), rsv_size(t_rsv));
+  t_rst->m_bytes += rsv_size(t_rsv);
+  t_rst->m_offsets[++t_rst->m_size] = t_rst->m_bytes;
+}
+
+/// @internal
+static inline rsv _rst_at(struct rst *t_rst, size_t t_index) {
+  size_t begin = t_rst->m_offsets[t_index];
+  return (rsv){.m_size = t_rst->m_offsets[t_index + 1] - begin,
+               .m_str = t_rst->m_blob + begin};
+}
+
+/// @internal
+RST_INTERNAL_DEF
+inline bool _rst_index_bounds_check(const char *t_file, int t_line,
+                                    struct rst *t_rst, size_t t_index) {
+  if (t_index < rst_size(t_rst))
+    return true;
+  fprintf(stderr,
+          "Error: string table index is out of bounds, file: %s, line: %d\n",
+          t_file, t_line);
+  exit(EXIT_FAILURE);
+}
+
+/// @brief Get a view of the string at t_index, it is valid until the next
+/// change of the rst.
+#define rst_at(t_rst, t_index)                                                 \
+  (_rst_index_bounds_check(__FILE__, __LINE__, (t_rst), (t_index)),            \
+   _rst_at((t_rst), (t_index)))
+
+/// @brief Get an iterator at the start of a rst.
+static inline struct rst_iter rst_iter(struct rst *t_rst) {
+  return (struct rst_iter){.m_rst = t_rst};
+}
+
+/// @brief Get the next string, the strings are read in order of the buffer.
+/// @return false when all the strings were read
+static inline bool rst_iter_next(struct rst_iter *t_iter, rsv *t_rsv) {
+  if (t_iter->m_index >= t_iter->m_rst->m_size) {
+    return false;
+  }
+  *t_rsv = _rst_at(t_iter->m_rst, t_iter->m_index++);
+  return true;
+}
+
+#define rst_for_each(t_rsv, t_rst)                                             \
+  for (struct rst_iter t_rsv##_iter = rst_iter(t_rst); t_rsv##_iter.m_rst;     \
+       t_rsv##_iter.m_rst = NULL)                                              \
+    for (rsv t_rsv; rst_iter_next(&t_rsv##_iter, &t_rsv);)
+
+/// @internal
+/// @brief A string to sort, with its first 8 characters as a big endian
+/// integer so most comparisons don't touch the buffer.
+struct _rst_sort_key {
+  uint64_t m_prefix;
+  size_t m_index;
+};
+
+/// @internal
+static inline bool _rst_sort_less(struct rst *t_rst,
+                                  const struct _rst_sort_key *t_key,
+                                  const struct _rst_sort_key *t_key_other) {
+  if (t_key->m_prefix != t_key_other->m_prefix) {
+    return t_key->m_prefix < t_key_other->m_prefix;
+  }
+  rsv str = _rst_at(t_rst, t_key->m_index);
+  rsv other = _rst_at(t_rst, t_key_other->m_index);
+  // Equal prefixes of two long strings are equal characters, a shorter one
+  // may have been padded with zeros
+  if (rsv_size(str) >= 8 && rsv_size(other) >= 8) {
+    str = rsv_substr(str, 8, RSV_NPOS);
+    other = rsv_substr(other, 8, RSV_NPOS);
+  }
+  return rsv_cmp(str, other) < 0;
+}
+
+/// @internal
+/// @brief Stable merge sort, t_tmp holds as many keys as t_keys
+static inline void _rst_merge_sort(struct rst *t_rst,
+                                   struct _rst_sort_key *t_keys,
+                                   struct _rst_sort_key *t_tmp,
+                                   size_t t_count) {
+  if (t_count <= 16) {
+    for (size_t i = 1; i < t_count; i++) {
+      struct _rst_sort_key key = t_keys[i];
+      size_t j = i;
+      for (; j > 0 && _rst_sort_less(t_rst, &key, &t_keys[j - 1]); j--) {
+        t_keys[j] = t_keys[j - 1];
+      }
+      t_keys[j] = key;
+    }
+    return;
+  }
+  size_t half = t_count / 2;
+  _rst_merge_sort(t_rst, t_keys, t_tmp, half);
+  _rst_merge_sort(t_rst, t_keys + half, t_tmp, t_count - half);
+  if (!_rst_sort_less(t_rst, &t_keys[half], &t_keys[half - 1])) {
+    return;
+  }
+  memcpy(t_tmp, t_keys, half * sizeof(*t_keys));
+  size_t i = 0, j = half, k = 0;
+  while (i < half && j < t_count) {
+    if (_rst_sort_less(t_rst, &t_keys[j], &t_tmp[i])) {
+      t_keys[k++] = t_keys[j++];
+    } else {
+      t_keys[k++] = t_tmp[i++];
+    }
+  }
+  memcpy(t_keys + k, t_tmp + i, (half - i) * sizeof(*t_keys));
+}
+
+/// @internal
+RST_INTERNAL_DEF inline void
+_rst_sort_with_location(const char *t_file, int t_line, struct rst *t_rst,
+                        size_t *t_perm, rda_allocator *t_allocator) {
+  size_t count = rst_size(t_rst);
+  size_t bytes = (count ? count : 1) * sizeof(struct _rst_sort_key);
+  struct _rst_sort_key *keys =
+      (struct _rst_sort_key *)t_allocator->alloc(t_allocator->m_ctx, bytes);
+  struct _rst_sort_key *tmp =
+      (struct _rst_sort_key *)t_allocator->alloc(t_allocator->m_ctx, bytes);
+  if (!keys || !tmp) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  for (size_t i = 0; i < count; i++) {
+    rsv str = _rst_at(t_rst, i);
+    uint64_t prefix = 0;
+    for (size_t j = 0; j < 8; j++) {
+      unsigned char ch = j < rsv_size(str) ? (unsigned char)str.m_str[j] : 0;
+      prefix = prefix << 8 | ch;
+    }
+    keys[i] = (struct _rst_sort_key){.m_prefix = prefix, .m_index = i};
+  }
+  _rst_merge_sort(t_rst, keys, tmp, count);
+  for (size_t i = 0; i < count; i++) {
+    t_perm[i] = keys[i].m_index;
+  }
+  t_allocator->free(t_allocator->m_ctx, tmp);
+  t_allocator->free(t_allocator->m_ctx, keys);
+}
+
+/// @brief Sort the strings by their characters, without moving them.
+///
+/// t_perm gets the indices of the strings in sorted order, equal strings
+/// keep their order. The strings compare like `rsv_cmp()`.
+/// @param t_perm Room for `rst_size()` indices
+#define rst_sort(t_rst, t_perm, t_allocator)                                   \
+  _rst_sort_with_location(__FILE__, __LINE__, (t_rst), (t_perm),               \
+                          (t_allocator))
+
+/// @internal
+RST_INTERNAL_DEF inline void
+_rst_dedup_with_location(const char *t_file, int t_line, struct rst *t_rst,
+                         size_t *t_ids, rda_allocator *t_allocator) {
+  size_t count = rst_size(t_rst);
+  // Open addressing, at most half full. A slot holds a kept string's new
+  // index plus 1, 0 is an empty slot.
+  size_t slot_count = 16;
+  while (slot_count < count * 2) {
+    slot_count *= 2;
+  }
+  size_t *slots = (size_t *)t_allocator->alloc(t_allocator->m_ctx,
+                                               slot_count * sizeof(size_t));
+  uint64_t *hashes = (uint64_t *)t_allocator->alloc(
+      t_allocator->m_ctx, (count ? count : 1) * sizeof(uint64_t));
+  if (!slots || !hashes) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  memset(slots, 0, slot_count * sizeof(size_t));
+  // Kept strings only move towards the front, so a string is always read
+  // before anything is written over it
+  size_t kept = 0;
+  for (size_t i = 0; i < count; i++) {
+    rsv str = _rst_at(t_rst, i);
+    uint64_t hash = rsv_hash(str);
+    size_t slot = (size_t)hash & (slot_count - 1);
+    size_t id = kept;
+    for (; slots[slot]; slot = (slot + 1) & (slot_count - 1)) {
+      size_t other = slots[slot] - 1;
+      if (hashes[other] == hash && rsv_eq(_rst_at(t_rst, other), str)) {
+        id = other;
+        break;
+      }
+    }
+    if (id == kept) {
+      slots[slot] = kept + 1;
+      hashes[kept] = hash;
+      size_t begin = t_rst->m_offsets[kept];
+      memmove(t_rst->m_blob + begin, str.m_str, rsv_size(str));
+      t_rst->m_offsets[++kept] = begin + rsv_size(str);
+    }
+    if (t_ids) {
+      t_ids[i] = id;
+    }
+  }
+  t_rst->m_size = kept;
+  t_rst->m_bytes = t_rst->m_offsets[kept];
+  t_allocator->free(t_allocator->m_ctx, hashes);
+  t_allocator->free(t_allocator->m_ctx, slots);
+}
+
+/// @brief Remove the strings that are equal to an earlier one.
+///
+/// The first of the equal strings is kept, the kept strings stay in order
+/// and are moved together at the front of the buffer.
+/// @param t_ids NULL, or room for `rst_size()` indices, t_ids[i] gets the new
+/// index of the string that was at i
+#define rst_dedup(t_rst, t_ids, t_allocator)                                   \
+  _rst_dedup_with_location(__FILE__, __LINE__, (t_rst), (t_ids),               \
+                           (t_allocator))
+
+#endif // RIT_STRTAB_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -0,0 +1,330 @@
+// LICENSE
+// See end of the file for license information.
+
+#ifndef RCA_INTERNAL_DEF
+#define RCA_INTERNAL_DEF static
+#endif // RCA_INTERNAL_DEF
+
+#ifndef RIT_VARINT_ARR_H_INCLUDED
+#define RIT_VARINT_ARR_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rit_dyn_arr.h"
+
+// Disable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/// @brief Number of values in a block, every block can be decoded on its own
+#define RCA_BLOCK_SIZE 128
+#define DEFAULT_RCA_CAP 256
+
+/// @brief Skip entry of a block, holding its first value uncompressed
+struct rca_skip {
+  uint64_t m_first;
+  size_t m_offset; // Offset of the block's deltas in the byte array
+};
+
+/// @brief Compressed array of non-decreasing integers.
+///
+/// Values are stored as LEB128 varint deltas from their predecessor, in blocks
+/// of RCA_BLOCK_SIZE values. Every block has a skip entry, so random access and
+/// searching only decode a single block.
+struct rca {
+  size_t m_size;            // Do not modify this, this is private
+  size_t m_capacity;        // Do not modify this, this is private
+  size_t m_bytes;           // Do not modify this, this is private
+  uint8_t *m_data;          // Do not modify this, this is private
+  size_t m_skip_capacity;   // Do not modify this, this is private
+  struct rca_skip *m_skips; // Do not modify this, this is private
+  uint64_t m_last;          // Do not modify this, this is private
+};
+
+/// @brief Sequential decoder of a rca
+struct rca_iter {
+  struct rca *m_rca; // Do not modify this, this is private
+  size_t m_index;    // Do not modify this, this is private
+  size_t m_offset;   // Do not modify this, this is private
+  uint64_t m_value;  // Do not modify this, this is private
+};
+
+/// @brief Number of values stored
+static inline size_t rca_size(struct rca *t_rca) { return t_rca->m_size; }
+
+/// @brief Number of bytes used by the compressed values and the skip entries
+static inline size_t rca_bytes(struct rca *t_rca) {
+  return t_rca->m_bytes + (t_rca->m_size + RCA_BLOCK_SIZE - 1) /
+                              RCA_BLOCK_SIZE * sizeof(struct rca_skip);
+}
+
+/// @internal
+RCA_INTERNAL_DEF inline void
+_rca_init_with_location(const char *t_file, int t_line, struct rca *t_rca,
+                        rda_allocator *t_allocator) {
+  *t_rca = (struct rca){};
+  t_rca->m_data =
+      (uint8_t *)t_allocator->alloc(t_allocator->m_ctx, DEFAULT_RCA_CAP);
+  t_rca->m_skips = (struct rca_skip *)t_allocator->alloc(
+      t_allocator->m_ctx, DEFAULT_ARR_CAP * sizeof(struct rca_skip));
+  if (!t_rca->m_data || !t_rca->m_skips) {
+    fprintf(stderr, "Error: allocation failed, file: %s, line: %d\n", t_file,
+            t_line);
+    exit(EXIT_FAILURE);
+  }
+  t_rca->m_capacity = DEFAULT_RCA_CAP;
+  t_rca->m_skip_capacity = DEFAULT_ARR_CAP;
+}
+
+#define rca_init(t_rca, t_allocator)                                           \
+  _rca_init_with_location(__FILE__, __LINE__, (t_rca), (t_allocator))
+
+/// @brief Create an empty rca.
+#define rca(t_rca, t_allocator)                                                \
+  struct rca t_rca;                                                            \
+  rca_init(&t_rca, (t_allocator))
+
+static inline void rca_free(struct rca *t_rca, rda_allocator *t_allocator) {
+  t_allocator->free(t_allocator->m_ctx, t_rca->m_data);
+  t_allocator->free(t_allocator->m_ctx, t_rca->m_skips);
+}
+
+/// @brief Empty out a rca.
+static inline void rca_clear(struct rca *t_rca) {
+  t_rca->m_size = 0;
+  t_rca->m_bytes = 0;
+  t_rca->m_last = 0;
+}
+
+/// @internal
+RCA_INTERNAL_DEF inline void
+_rca_push_back_with_location(const char *t_file, int t_line,
+                             struct rca *t_rca, uint64_t t_val,
+                             rda_allocator *t_allocator) {
+  if (t_rca->m_size > 0 && t_val < t_rca->m_last) {
+    fprintf(stderr,
+            "Error: values of a compressed array must not decrease, file: %s, "
+            "line: %d\n",
+            t_file, t_line);
+    exit(EXIT_FAILURE);
+  }
+  if (t_rca->m_size % RCA_BLOCK_SIZE == 0) {
+    size_t block = t_rca->m_size / RCA_BLOCK_SIZE;
+    if (block == t_rca->m_skip_capacity) {
+      t_rca->m_skips = (struct rca_skip *)t_allocator->realloc(
+          t_allocator->m_ctx, t_rca->m_skips,
+          t_rca->m_skip_capacity * sizeof(struct rca_skip),
+          t_rca->m_skip_capacity * 2 * sizeof(struct rca_skip));
+      if (!t_rca->m_skips) {
+        fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n",
+                t_file, t_line);
+        exit(EXIT_FAILURE);
+      }
+      t_rca->m_skip_capacity *= 2;
+    }
+    t_rca->m_skips[block] =
+        (struct rca_skip){.m_first = t_val, .m_offset = t_rca->m_bytes};
+  } else {
+    // A varint takes at most 10 bytes
+    if (t_rca->m_bytes + 10 > t_rca->m_capacity) {
+      t_rca->m_data = (uint8_t *)t_allocator->realloc(
+          t_allocator->m_ctx, t_rca->m_data, t_rca->m_capacity,
+          t_rca->m_capacity * 2);
+      if (!t_rca->m_data) {
+        fprintf(stderr, "Error: reallocation failed, file: %s, line: %d\n",
+                t_file, t_line);
+        exit(EXIT_FAILURE);
+      }
+      t_rca->m_capacity *= 2;
+    }
+    uint64_t delta = t_val - t_rca->m_last;
+    while (delta >= 0x80) {
+      t_rca->m_data[t_rca->m_bytes++] = (uint8_t)(delta | 0x80);
+      delta >>= 7;
+    }
+    t_rca->m_data[t_rca->m_bytes++] = (uint8_t)delta;
+  }
+  t_rca->m_last = t_val;
+  t_rca->m_size++;
+}
+
+/// @brief Append a value, it must not be smaller than the last value.
+#define rca_push_back(t_rca, t_val, t_allocator)                               \
+  _rca_push_back_with_location(__FILE__, __LINE__, (t_rca), (t_val),           \
+                               (t_allocator))
+
+/// @internal
+/// @brief Decode one varint at *t_offset
+static inline uint64_t _rca_decode(const uint8_t *t_data, size_t *t_offset) {
+  const uint8_t *ptr = t_data + *t_offset;
+  // Most deltas of dense lists fit in a single byte
+  if (ptr[0] < 0x80) {
+    *t_offset += 1;
+    return ptr[0];
+  }
+  uint64_t val = ptr[0] & 0x7F;
+  size_t size = 1;
+  for (int shift = 7;; shift += 7) {
+    uint8_t byte = ptr[size++];
+    val |= (uint64_t)(byte & 0x7F) << shift;
+    if (byte < 0x80) {
+      break;
+    }
+  }
+  *t_offset += size;
+  return val;
+}
+
+/// @internal
+RCA_INTERNAL_DEF
+inline bool _rca_index_bounds_check(const char *t_file, int t_line,
+                                    struct rca *t_rca, size_t t_index) {
+  if (t_index < rca_size(t_rca))
+    return true;
+  fprintf(stderr,
+          "Error: compressed array index is out of bounds, file: %s, line: "
+          "%d\n",
+          t_file, t_line);
+  exit(EXIT_FAILURE);
+}
+
+/// @internal
+static inline uint64_t _rca_at(struct rca *t_rca, size_t t_index) {
+  struct rca_skip *skip = &t_rca->m_skips[t_index / RCA_BLOCK_SIZE];
+  uint64_t val = skip->m_first;
+  size_t offset = skip->m_offset;
+  for (size_t i = t_index % RCA_BLOCK_SIZE; i > 0; i--) {
+    val += _rca_decode(t_rca->m_data, &offset);
+  }
+  return val;
+}
+
+/// @brief Get the value at t_index, decoding at most one block.
+#define rca_at(t_rca, t_index)                                                 \
+  (_rca_index_bounds_check(__FILE__, __LINE__, (t_rca), (t_index)),            \
+   _rca_at((t_rca), (t_index)))
+
+/// @brief Get an iterator at the start of a rca.
+static inline struct rca_iter rca_iter(struct rca *t_rca) {
+  return (struct rca_iter){.m_rca = t_rca};
+}
+
+/// @brief Decode the next value.
+/// @return false when all the values were decoded
+static inline bool rca_iter_next(struct rca_iter *t_iter, uint64_t *t_val) {
+  struct rca *rca = t_iter->m_rca;
+  if (t_iter->m_index >= rca->m_size) {
+    return false;
+  }
+  if (t_iter->m_index % RCA_BLOCK_SIZE == 0) {
+    struct rca_skip *skip = &rca->m_skips[t_iter->m_index / RCA_BLOCK_SIZE];
+    t_iter->m_value = skip->m_first;
+    t_iter->m_offset = skip->m_offset;
+  } else {
+    t_iter->m_value += _rca_decode(rca->m_data, &t_iter->m_offset);
+  }
+  t_iter->m_index++;
+  *t_val = t_iter->m_value;
+  return true;
+}
+
+/// @brief Decode the following values until one is >= t_target.
+///
+/// Whole blocks are skipped by binary searching their first values, so only
+/// the block holding the result gets decoded.
+/// @return false if there is no such value
+static inline bool rca_iter_skip_to(struct rca_iter *t_iter, uint64_t t_target,
+                                    uint64_t *t_val) {
+  struct rca *rca = t_iter->m_rca;
+  size_t block_count = (rca->m_size + RCA_BLOCK_SIZE - 1) / RCA_BLOCK_SIZE;
+  size_t block = t_iter->m_index / RCA_BLOCK_SIZE;
+  if (block + 1 < block_count && rca->m_skips[block + 1].m_first < t_target) {
+    // Find the last block starting with a value < t_target, the result is in
+    // that block or is the first value of the next one
+    size_t low = block + 1, high = block_count;
+    while (high - low > 1) {
+      size_t mid = low + (high - low) / 2;
+      if (rca->m_skips[mid].m_first < t_target) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    t_iter->m_index = low * RCA_BLOCK_SIZE;
+  }
+  uint64_t val;
+  while (rca_iter_next(t_iter, &val)) {
+    if (val >= t_target) {
+      *t_val = val;
+      return true;
+    }
+  }
+  return false;
+}
+
+/// @brief Store the values found in both t_rca and t_rca_other in t_result.
+///
+/// The shorter array is decoded sequentially, the longer one is searched with
+/// rca_iter_skip_to(), so blocks without candidates are never decoded.
+static inline void rca_intersect(struct rca *t_result, struct rca *t_rca,
+                                 struct rca *t_rca_other,
+                                 rda_allocator *t_allocator) {
+  if (rca_size(t_rca) > rca_size(t_rca_other)) {
+    struct rca *tmp = t_rca;
+    t_rca = t_rca_other;
+    t_rca_other = tmp;
+  }
+  struct rca_iter it = rca_iter(t_rca);
+  struct rca_iter it_other = rca_iter(t_rca_other);
+  uint64_t val, val_other = 0;
+  bool has_other = false;
+  while (rca_iter_next(&it, &val)) {
+    if (!has_other || val_other < val) {
+      if (!rca_iter_skip_to(&it_other, val, &val_other)) {
+        return;
+      }
+      has_other = true;
+    }
+    if (val_other == val) {
+      rca_push_back(t_result, val, t_allocator);
+      has_other = false;
+    }
+  }
+}
+
+#define rca_for_each(t_val, t_rca)                                             \
+  for (struct rca_iter t_val##_iter = rca_iter(t_rca); t_val##_iter.m_rca;     \
+       t_val##_iter.m_rca = NULL)                                              \
+    for (uint64_t t_val; rca_iter_next(&t_val##_iter, &t_val);)
+
+#endif // RIT_VARINT_ARR_H_INCLUDED
+
+// Enable MSVC warning 4702: unreachable code
+#pragma warning(disable : 4702)
+
+/*
+The MIT License (MIT)
+
+Copyright 2024 Ritchiel Reza
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the “Software”), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/